@@ -0,0 +1,14 @@
+//
+//  EXTADTTableTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTADTTable.h"
+
+@interface EXTADTTableTest : XCTestCase
+
+@end
@@ -0,0 +1,193 @@
+//
+//  EXTADTTableTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTADTTableTest.h"
+
+static const NSUInteger EXTADTTableTestKeyCount = 100000;
+
+ADT(Shape,
+    constructor(Point),
+    constructor(Circle, double radius),
+    constructor(Rect, double width, double height),
+    constructor(Labeled, __unsafe_unretained NSString *label)
+);
+
+ADTMap(ShapeCounts, Shape, NSUInteger);
+ADTSet(ShapeSet, Shape);
+
+@implementation EXTADTTableTest
+
+- (void)testMap {
+    ShapeCountsT *counts = ShapeCountsCreate(0);
+    XCTAssertTrue(counts != NULL, @"");
+    XCTAssertEqual(ShapeCountsCount(counts), (size_t)0, @"");
+    XCTAssertTrue(ShapeCountsGet(counts, Shape.Point()) == NULL, @"");
+
+    XCTAssertTrue(ShapeCountsSet(counts, Shape.Point(), 1), @"");
+    XCTAssertTrue(ShapeCountsSet(counts, Shape.Circle(2.0), 2), @"");
+    XCTAssertTrue(ShapeCountsSet(counts, Shape.Rect(2.0, 3.0), 3), @"");
+    XCTAssertEqual(ShapeCountsCount(counts), (size_t)3, @"");
+
+    XCTAssertEqual(*ShapeCountsGet(counts, Shape.Point()), (NSUInteger)1, @"");
+    XCTAssertEqual(*ShapeCountsGet(counts, Shape.Circle(2.0)), (NSUInteger)2, @"");
+    XCTAssertEqual(*ShapeCountsGet(counts, Shape.Rect(2.0, 3.0)), (NSUInteger)3, @"");
+    XCTAssertTrue(ShapeCountsGet(counts, Shape.Rect(3.0, 2.0)) == NULL, @"");
+
+    // replacing and modifying values in place
+    XCTAssertTrue(ShapeCountsSet(counts, Shape.Circle(2.0), 5), @"");
+    ++*ShapeCountsGet(counts, Shape.Point());
+
+    XCTAssertEqual(ShapeCountsCount(counts), (size_t)3, @"");
+    XCTAssertEqual(*ShapeCountsGet(counts, Shape.Point()), (NSUInteger)2, @"");
+    XCTAssertEqual(*ShapeCountsGet(counts, Shape.Circle(2.0)), (NSUInteger)5, @"");
+
+    XCTAssertTrue(ShapeCountsRemove(counts, Shape.Circle(2.0)), @"");
+    XCTAssertFalse(ShapeCountsRemove(counts, Shape.Circle(2.0)), @"");
+    XCTAssertTrue(ShapeCountsGet(counts, Shape.Circle(2.0)) == NULL, @"");
+    XCTAssertEqual(ShapeCountsCount(counts), (size_t)2, @"");
+
+    ShapeCountsDestroy(counts);
+}
+
+- (void)testKeysUseADTEquality {
+    ShapeCountsT *counts = ShapeCountsCreate(0);
+
+    XCTAssertTrue(ShapeCountsSet(counts, Shape.Labeled(@"foobar"), 1), @"");
+    XCTAssertTrue(ShapeCountsSet(counts, Shape.Circle(0.0), 2), @"");
+
+    NSString *label = [NSMutableString stringWithString:@"foobar"];
+    XCTAssertTrue(ShapeCountsGet(counts, Shape.Labeled(label)) != NULL, @"");
+    XCTAssertTrue(ShapeCountsGet(counts, Shape.Circle(-0.0)) != NULL, @"");
+
+    ShapeCountsDestroy(counts);
+}
+
+- (void)testGrowingAndRemoving {
+    ShapeCountsT *counts = ShapeCountsCreate(0);
+
+    for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;++i) {
+        XCTAssertTrue(ShapeCountsSet(counts, Shape.Circle((double)i), i), @"");
+    }
+
+    XCTAssertEqual(ShapeCountsCount(counts), (size_t)EXTADTTableTestKeyCount, @"");
+
+    // remove every other key, to exercise shifting entries backward
+    for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;i += 2) {
+        XCTAssertTrue(ShapeCountsRemove(counts, Shape.Circle((double)i)), @"");
+    }
+
+    XCTAssertEqual(ShapeCountsCount(counts), (size_t)EXTADTTableTestKeyCount / 2, @"");
+
+    for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;++i) {
+        NSUInteger *value = ShapeCountsGet(counts, Shape.Circle((double)i));
+
+        if (i % 2 == 0) {
+            XCTAssertTrue(value == NULL, @"");
+        } else {
+            XCTAssertTrue(value != NULL, @"");
+            XCTAssertEqual(*value, i, @"");
+        }
+    }
+
+    ShapeCountsDestroy(counts);
+}
+
+- (void)testEnumeration {
+    ShapeCountsT *counts = ShapeCountsCreate(0);
+
+    for (NSUInteger i = 1;i <= 10;++i) {
+        ShapeCountsSet(counts, Shape.Rect((double)i, (double)i), i);
+    }
+
+    __block NSUInteger sum = 0;
+    ShapeCountsEnumerate(counts, ^(ShapeT key, NSUInteger *value, BOOL *stop){
+        XCTAssertEqual(key.tag, Rect, @"");
+        XCTAssertEqual((NSUInteger)key.width, *value, @"");
+
+        sum += *value;
+    });
+
+    XCTAssertEqual(sum, (NSUInteger)55, @"");
+
+    __block NSUInteger visited = 0;
+    ShapeCountsEnumerate(counts, ^(ShapeT key, NSUInteger *value, BOOL *stop){
+        if (++visited == 3)
+            *stop = YES;
+    });
+
+    XCTAssertEqual(visited, (NSUInteger)3, @"");
+
+    ShapeCountsDestroy(counts);
+}
+
+- (void)testSet {
+    ShapeSetT *set = ShapeSetCreate(100);
+    XCTAssertTrue(set != NULL, @"");
+
+    XCTAssertTrue(ShapeSetAdd(set, Shape.Point()), @"");
+    XCTAssertFalse(ShapeSetAdd(set, Shape.Point()), @"");
+    XCTAssertTrue(ShapeSetAdd(set, Shape.Labeled(@"foo")), @"");
+    XCTAssertEqual(ShapeSetCount(set), (size_t)2, @"");
+
+    XCTAssertTrue(ShapeSetContains(set, Shape.Point()), @"");
+    XCTAssertTrue(ShapeSetContains(set, Shape.Labeled(@"foo")), @"");
+    XCTAssertFalse(ShapeSetContains(set, Shape.Labeled(@"bar")), @"");
+
+    __block NSUInteger count = 0;
+    ShapeSetEnumerate(set, ^(ShapeT key, BOOL *stop){
+        ++count;
+    });
+
+    XCTAssertEqual(count, (NSUInteger)2, @"");
+
+    XCTAssertTrue(ShapeSetRemove(set, Shape.Point()), @"");
+    XCTAssertFalse(ShapeSetContains(set, Shape.Point()), @"");
+    XCTAssertEqual(ShapeSetCount(set), (size_t)1, @"");
+
+    ShapeSetDestroy(set);
+}
+
+- (void)testMapPerformance {
+    [self measureBlock:^{
+        ShapeCountsT *counts = ShapeCountsCreate(0);
+
+        for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;++i) {
+            ShapeCountsSet(counts, Shape.Rect((double)(i % 100), (double)(i / 100)), i);
+        }
+
+        NSUInteger found = 0;
+        for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;++i) {
+            if (ShapeCountsGet(counts, Shape.Rect((double)(i % 100), (double)(i / 100))))
+                ++found;
+        }
+
+        XCTAssertEqual(found, EXTADTTableTestKeyCount, @"");
+        ShapeCountsDestroy(counts);
+    }];
+}
+
+- (void)testDescriptionKeyedDictionaryPerformance {
+    // for comparison with -testMapPerformance
+    [self measureBlock:^{
+        NSMutableDictionary *counts = [NSMutableDictionary dictionary];
+
+        for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;++i) {
+            counts[NSStringFromShape(Shape.Rect((double)(i % 100), (double)(i / 100)))] = @(i);
+        }
+
+        NSUInteger found = 0;
+        for (NSUInteger i = 0;i < EXTADTTableTestKeyCount;++i) {
+            if (counts[NSStringFromShape(Shape.Rect((double)(i % 100), (double)(i / 100)))])
+                ++found;
+        }
+
+        XCTAssertEqual(found, EXTADTTableTestKeyCount, @"");
+    }];
+}
+
+@end
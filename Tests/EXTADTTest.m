@@ -46,6 +46,33 @@ ADT(MaxConstructors,
     constructor(MaxParams19, int C19P1, int C19P2, int C19P3, int C19P4, int C19P5, int C19P6, int C19P7, int C19P8, int C19P9, int C19P10, int C19P11, int C19P12, int C19P13, int C19P14, int C19P15, int C19P16, int C19P17, int C19P18, int C19P19)
 );
 
+ADT(Sample,
+    constructor(NoSample),
+    constructor(ShortSample, int16_t sample)
+);
+
+CompactADT(CompactSample,
+    constructor(NoCompactSample),
+    constructor(ShortCompactSample, int16_t sample)
+);
+
+typedef struct {
+    char flag;
+    double value;
+} PaddedSample;
+
+ADT(Measurement,
+    constructor(NoMeasurement),
+    constructor(PaddedMeasurement, PaddedSample sample)
+);
+
+PackedADT(PackedSample,
+    constructor(NoPackedSample),
+    constructor(BytePackedSample, uint8_t byte),
+    constructor(DoublePackedSample, double value),
+    constructor(NamedPackedSample, __unsafe_unretained NSString *sampleName)
+);
+
 @implementation EXTADTTest
 
 - (void)testRed {
@@ -106,6 +133,445 @@ ADT(MaxConstructors,
     XCTAssertTrue(MulticolorEqualToMulticolor(c2, Multicolor.RecursiveColor(&c1)), @"");
 }
 
+- (void)testWriteDescription {
+    char buffer[64];
+
+    size_t length = ColorWriteDescription(Color.Other(1.0, 0.5, 0.25), buffer, sizeof(buffer));
+    XCTAssertEqual(length, strlen("Other { r = 1, g = 0.5, b = 0.25 }"), @"");
+    XCTAssertEqual(strcmp(buffer, "Other { r = 1, g = 0.5, b = 0.25 }"), 0, @"");
+
+    length = ColorWriteDescription(Color.Red(), buffer, sizeof(buffer));
+    XCTAssertEqual(length, (size_t)3, @"");
+    XCTAssertEqual(strcmp(buffer, "Red"), 0, @"");
+
+    length = ColorWriteDescription(Color.Named(nil), buffer, sizeof(buffer));
+    XCTAssertEqual(strcmp(buffer, "Named { name = (nil) }"), 0, @"");
+}
+
+- (void)testWriteDescriptionTruncates {
+    char buffer[8];
+
+    size_t length = ColorWriteDescription(Color.Gray(0.75), buffer, sizeof(buffer));
+    XCTAssertEqual(length, strlen("Gray { alpha = 0.75 }"), @"expected the length of the whole description");
+    XCTAssertEqual(strcmp(buffer, "Gray { "), 0, @"");
+
+    XCTAssertEqual(ColorWriteDescription(Color.Gray(0.75), NULL, 0), length, @"");
+}
+
+- (void)testWriteDescriptionPerformance {
+    [self measureBlock:^{
+        char buffer[128];
+        size_t total = 0;
+
+        for (NSUInteger i = 0;i < 100000;++i) {
+            total += ColorWriteDescription(Color.Other((double)i, 0.5, 0.25), buffer, sizeof(buffer));
+        }
+
+        XCTAssertTrue(total > 0, @"");
+    }];
+}
+
+- (void)testStringDescriptionPerformance {
+    // for comparison with -testWriteDescriptionPerformance
+    [self measureBlock:^{
+        NSUInteger total = 0;
+
+        for (NSUInteger i = 0;i < 100000;++i) {
+            @autoreleasepool {
+                total += NSStringFromColor(Color.Other((double)i, 0.5, 0.25)).length;
+            }
+        }
+
+        XCTAssertTrue(total > 0, @"");
+    }];
+}
+
+- (void)testLayout {
+    XCTAssertEqual((size_t)SampleSize, sizeof(SampleT), @"");
+    XCTAssertEqual((size_t)SampleAlignment, __alignof__(SampleT), @"");
+
+    XCTAssertEqual((size_t)CompactSampleSize, (size_t)4, @"expected a one-byte tag");
+    XCTAssertTrue(CompactSampleSize < SampleSize, @"");
+
+    XCTAssertEqual((size_t)PackedSampleSize, 1 + sizeof(double), @"expected no padding");
+    XCTAssertEqual((size_t)PackedSampleAlignment, (size_t)1, @"");
+}
+
+- (void)testCompactADT {
+    CompactSampleT s = CompactSample.ShortCompactSample(-5);
+    XCTAssertEqual(s.tag, ShortCompactSample, @"");
+    XCTAssertEqual(s.sample, (int16_t)-5, @"");
+
+    XCTAssertTrue(CompactSampleEqualToCompactSample(s, CompactSample.ShortCompactSample(-5)), @"");
+    XCTAssertFalse(CompactSampleEqualToCompactSample(s, CompactSample.NoCompactSample()), @"");
+    XCTAssertEqualObjects(NSStringFromCompactSample(s), @"ShortCompactSample { sample = -5 }", @"");
+}
+
+- (void)testPackedADT {
+    // every element after the first has a misaligned payload
+    PackedSampleT samples[] = {
+        PackedSample.DoublePackedSample(0.5),
+        PackedSample.DoublePackedSample(0.25),
+        PackedSample.NamedPackedSample(@"foobar"),
+        PackedSample.BytePackedSample(0xff),
+        PackedSample.NoPackedSample(),
+    };
+
+    XCTAssertEqual(samples[1].tag, DoublePackedSample, @"");
+    XCTAssertEqual(samples[1].value, 0.25, @"");
+    XCTAssertEqualObjects(samples[2].sampleName, @"foobar", @"");
+    XCTAssertEqual(samples[3].byte, (uint8_t)0xff, @"");
+
+    XCTAssertTrue(PackedSampleEqualToPackedSample(samples[1], PackedSample.DoublePackedSample(0.25)), @"");
+    XCTAssertFalse(PackedSampleEqualToPackedSample(samples[0], samples[1]), @"");
+    XCTAssertTrue(PackedSampleEqualToPackedSample(samples[2], PackedSample.NamedPackedSample(@"foobar")), @"");
+    XCTAssertEqual(PackedSampleHash(samples[1]), PackedSampleHash(PackedSample.DoublePackedSample(0.25)), @"");
+
+    XCTAssertEqualObjects(NSStringFromPackedSample(samples[1]), @"DoublePackedSample { value = 0.25 }", @"");
+    XCTAssertEqualObjects(NSStringFromPackedSample(samples[2]), @"NamedPackedSample { sampleName = foobar }", @"");
+    XCTAssertEqualObjects(NSStringFromPackedSample(samples[4]), @"NoPackedSample", @"");
+}
+
+- (void)testMatch {
+    ColorT colors[] = { Color.Red(), Color.Gray(0.25), Color.Other(1.0, 0.5, 0.25), Color.Named(@"foobar") };
+    NSMutableArray *results = [NSMutableArray array];
+
+    for (size_t i = 0;i < sizeof(colors) / sizeof(*colors);++i) {
+        ext_match (colors[i]) {
+            ext_with(Red)
+                [results addObject:@"red"];
+                break;
+
+            ext_with(Gray, alpha)
+                [results addObject:@(alpha)];
+                break;
+
+            ext_with(Other, b, r) {
+                // parameters can be bound in any order
+                [results addObject:@(r + b)];
+                break;
+            }
+
+            default:
+                [results addObject:@"default"];
+        }
+    }
+
+    NSArray *expected = @[ @"red", @0.25, @1.25, @"default" ];
+    XCTAssertEqualObjects(results, expected, @"");
+}
+
+- (void)testMatchEvaluatesValueOnce {
+    __block NSUInteger evaluations = 0;
+    ColorT (^makeColor)(void) = ^{
+        ++evaluations;
+        return Color.Named(@"foobar");
+    };
+
+    NSString *matchedName = nil;
+
+    ext_match (makeColor()) {
+        ext_with(Named, name)
+            matchedName = name;
+            break;
+
+        default:
+            XCTFail(@"expected Named to be matched");
+    }
+
+    XCTAssertEqual(evaluations, (NSUInteger)1, @"");
+    XCTAssertEqualObjects(matchedName, @"foobar", @"");
+}
+
+- (void)testArray {
+    ColorArrayT *colors = ColorArrayCreate();
+    XCTAssertTrue(colors != NULL, @"");
+
+    for (NSUInteger i = 0;i < 100;++i) {
+        ColorT color = (i % 2 == 0 ? Color.Gray((double)i) : Color.Other((double)i, 0.5, -(double)i));
+        XCTAssertTrue(ColorArrayAppend(colors, color), @"");
+    }
+
+    XCTAssertTrue(ColorArrayAppend(colors, Color.Red()), @"");
+    XCTAssertTrue(ColorArrayAppend(colors, Color.Named(@"foobar")), @"");
+
+    XCTAssertEqual(ColorArrayCount(colors), (size_t)102, @"");
+    XCTAssertEqual(colors->Gray.count, (size_t)50, @"");
+    XCTAssertEqual(colors->Other.count, (size_t)50, @"");
+    XCTAssertEqual(colors->Red.count, (size_t)1, @"");
+
+    // each constructor's parameters are stored contiguously
+    double total = 0;
+    for (size_t i = 0;i < colors->Other.count;++i) {
+        total += colors->Other.v0[i].r + colors->Other.v2[i].b;
+    }
+
+    XCTAssertEqual(total, 0.0, @"");
+
+    XCTAssertTrue(ColorEqualToColor(ColorArrayGet(colors, 4), Color.Gray(4.0)), @"");
+    XCTAssertTrue(ColorEqualToColor(ColorArrayGet(colors, 5), Color.Other(5.0, 0.5, -5.0)), @"");
+    XCTAssertTrue(ColorEqualToColor(ColorArrayGet(colors, 100), Color.Red()), @"");
+    XCTAssertTrue(ColorEqualToColor(ColorArrayGet(colors, 101), Color.Named(@"foobar")), @"");
+
+    ColorArrayDestroy(colors);
+}
+
+- (void)testArrayFilterAndCompact {
+    ColorArrayT *colors = ColorArrayCreate();
+
+    for (NSUInteger i = 0;i < 100;++i) {
+        ColorArrayAppend(colors, (i % 2 == 0 ? Color.Gray((double)i) : Color.Other((double)i, 0.5, 0.25)));
+    }
+
+    // keep every third value
+    ColorArrayFilter(colors, ^ BOOL (ColorT color){
+        double value = (color.tag == Gray ? color.alpha : color.r);
+        return (NSUInteger)value % 3 == 0;
+    });
+
+    XCTAssertEqual(ColorArrayCount(colors), (size_t)34, @"");
+    XCTAssertEqual(colors->Gray.count, (size_t)17, @"");
+    XCTAssertEqual(colors->Other.count, (size_t)17, @"");
+
+    for (size_t i = 0;i < ColorArrayCount(colors);++i) {
+        ColorT color = ColorArrayGet(colors, i);
+        double expected = i * 3;
+
+        if (i % 2 == 0)
+            XCTAssertTrue(ColorEqualToColor(color, Color.Gray(expected)), @"");
+        else
+            XCTAssertTrue(ColorEqualToColor(color, Color.Other(expected, 0.5, 0.25)), @"");
+    }
+
+    ColorArrayCompact(colors);
+    XCTAssertEqual(colors->capacity, (size_t)34, @"");
+    XCTAssertEqual(colors->Gray.capacity, (size_t)17, @"");
+    XCTAssertTrue(ColorEqualToColor(ColorArrayGet(colors, 33), Color.Other(99.0, 0.5, 0.25)), @"");
+
+    ColorArrayRemoveAll(colors);
+    XCTAssertEqual(ColorArrayCount(colors), (size_t)0, @"");
+    XCTAssertEqual(colors->Other.count, (size_t)0, @"");
+
+    XCTAssertTrue(ColorArrayAppend(colors, Color.Blue()), @"");
+    XCTAssertTrue(ColorEqualToColor(ColorArrayGet(colors, 0), Color.Blue()), @"");
+
+    ColorArrayDestroy(colors);
+}
+
+- (void)testColumnIterationPerformance {
+    ColorArrayT *colors = ColorArrayCreate();
+
+    for (NSUInteger i = 0;i < 1000000;++i) {
+        ColorArrayAppend(colors, (i % 4 == 0 ? Color.Gray(0.5) : Color.Other(1.0, 0.5, 0.25)));
+    }
+
+    [self measureBlock:^{
+        double total = 0;
+        for (size_t i = 0;i < colors->Gray.count;++i) {
+            total += colors->Gray.v0[i].alpha;
+        }
+
+        XCTAssertEqual(total, 125000.0, @"");
+    }];
+
+    ColorArrayDestroy(colors);
+}
+
+- (void)testTagBranchingPerformance {
+    // for comparison with -testColumnIterationPerformance
+    const size_t count = 1000000;
+    ColorT *colors = malloc(count * sizeof(*colors));
+
+    for (NSUInteger i = 0;i < count;++i) {
+        ColorT color = (i % 4 == 0 ? Color.Gray(0.5) : Color.Other(1.0, 0.5, 0.25));
+        memcpy(colors + i, &color, sizeof(color));
+    }
+
+    [self measureBlock:^{
+        double total = 0;
+        for (size_t i = 0;i < count;++i) {
+            if (colors[i].tag == Gray)
+                total += colors[i].alpha;
+        }
+
+        XCTAssertEqual(total, 125000.0, @"");
+    }];
+
+    free(colors);
+}
+
+- (void)testArchiveRecords {
+    ColorT colors[] = { Color.Red(), Color.Gray(0.5), Color.Other(1.0, 0.5, 0.25), Color.Gray(-0.0) };
+    const size_t count = sizeof(colors) / sizeof(*colors);
+
+    NSData *data = ColorArchive(colors, count);
+    XCTAssertNotNil(data, @"");
+    XCTAssertNil(ColorArchiveObjects(data.bytes, data.length, [NSSet setWithObject:[NSString class]]), @"expected no objects to be archived");
+
+    size_t recordCount = 0;
+    const ColorRecordT *records = ColorArchiveRecords(data.bytes, data.length, &recordCount);
+    XCTAssertTrue(records != NULL, @"");
+    XCTAssertEqual(recordCount, count, @"");
+
+    // parameters can be read directly from the records
+    XCTAssertEqual(records[0].tag, (uint8_t)Red, @"");
+    XCTAssertEqual(records[1].tag, (uint8_t)Gray, @"");
+    XCTAssertEqual(records[1].alpha, 0.5, @"");
+    XCTAssertEqual(records[2].g, 0.5, @"");
+
+    for (size_t i = 0;i < count;++i) {
+        ColorT decoded = ColorFromRecord(records + i, nil);
+
+        XCTAssertTrue(ColorEqualToColor(decoded, colors[i]), @"");
+        XCTAssertEqual(ColorHash(decoded), ColorHash(colors[i]), @"");
+    }
+}
+
+- (void)testArchiveObjects {
+    ColorT colors[] = { Color.Named(@"foobar"), Color.Gray(0.5), Color.Named(nil) };
+    const size_t count = sizeof(colors) / sizeof(*colors);
+
+    NSData *data = ColorArchive(colors, count);
+
+    size_t recordCount = 0;
+    const ColorRecordT *records = ColorArchiveRecords(data.bytes, data.length, &recordCount);
+    XCTAssertEqual(recordCount, count, @"");
+    XCTAssertNil(records[0].name, @"expected objects to be left out of records");
+
+    NSArray *objects = ColorArchiveObjects(data.bytes, data.length, [NSSet setWithObject:[NSString class]]);
+    XCTAssertEqual(objects.count, count, @"");
+
+    for (size_t i = 0;i < count;++i) {
+        ColorT decoded = ColorFromRecord(records + i, objects[i]);
+        XCTAssertTrue(ColorEqualToColor(decoded, colors[i]), @"");
+    }
+
+    XCTAssertFalse(ColorEqualToColor(ColorFromRecord(records, nil), colors[0]), @"");
+}
+
+- (void)testArchiveObjectsRejectsUnexpectedClasses {
+    ColorT colors[] = { Color.Named(@"foobar") };
+    NSData *data = ColorArchive(colors, 1);
+
+    XCTAssertNil(ColorArchiveObjects(data.bytes, data.length, [NSSet setWithObject:[NSNumber class]]), @"expected an object of a class which wasn't allowed to be rejected");
+    XCTAssertNotNil(ColorArchiveObjects(data.bytes, data.length, [NSSet setWithObject:[NSString class]]), @"");
+}
+
+- (void)testArchiveFromMappedFile {
+    ColorT colors[] = { Color.Gray(0.25), Color.Other(1.0, 0.5, 0.25) };
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    XCTAssertTrue([ColorArchive(colors, 2) writeToFile:path atomically:NO], @"");
+
+    NSError *error = nil;
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:&error];
+    XCTAssertNotNil(data, @"%@", error);
+
+    size_t recordCount = 0;
+    const ColorRecordT *records = ColorArchiveRecords(data.bytes, data.length, &recordCount);
+    XCTAssertEqual(recordCount, (size_t)2, @"");
+    XCTAssertEqual(records[0].alpha, 0.25, @"");
+    XCTAssertEqual(records[1].b, 0.25, @"");
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testArchiveValidation {
+    ColorT colors[] = { Color.Gray(0.5), Color.Other(1.0, 0.5, 0.25) };
+    NSData *data = ColorArchive(colors, 2);
+
+    size_t recordCount = 0;
+    XCTAssertTrue(ColorArchiveRecords(data.bytes, data.length - 1, &recordCount) == NULL, @"expected a truncated archive to be rejected");
+    XCTAssertTrue(ColorArchiveRecords(data.bytes, 4, &recordCount) == NULL, @"");
+    XCTAssertTrue(SampleArchiveRecords(data.bytes, data.length, &recordCount) == NULL, @"expected an archive of another type to be rejected");
+
+    NSMutableData *corrupted = [data mutableCopy];
+    ((char *)corrupted.mutableBytes)[0] = 'X';
+    XCTAssertTrue(ColorArchiveRecords(corrupted.bytes, corrupted.length, &recordCount) == NULL, @"");
+}
+
+- (void)testInequality {
+    XCTAssertFalse(ColorEqualToColor(Color.Red(), Color.Green()), @"");
+    XCTAssertFalse(ColorEqualToColor(Color.Gray(0.5), Color.Gray(0.75)), @"");
+    XCTAssertFalse(ColorEqualToColor(Color.Other(1.0, 0.5, 0.25), Color.Other(1.0, 0.5, 0.5)), @"");
+    XCTAssertFalse(ColorEqualToColor(Color.Named(@"foo"), Color.Named(@"bar")), @"");
+    XCTAssertFalse(ColorEqualToColor(Color.Named(@"foo"), Color.Named(nil)), @"");
+    XCTAssertFalse(MulticolorEqualToMulticolor(Multicolor.OneColor(Color.Red()), Multicolor.OneColor(Color.Blue())), @"");
+}
+
+- (void)testEqualityUsesValueSemantics {
+    XCTAssertTrue(ColorEqualToColor(Color.Gray(0.0), Color.Gray(-0.0)), @"expected floating-point values to be compared with ==");
+    XCTAssertFalse(ColorEqualToColor(Color.Gray(NAN), Color.Gray(NAN)), @"expected floating-point values to be compared with ==");
+
+    NSString *name = [NSMutableString stringWithString:@"foobar"];
+    XCTAssertTrue(ColorEqualToColor(Color.Named(name), Color.Named(@"foobar")), @"expected objects to be compared with -isEqual:");
+    XCTAssertTrue(ColorEqualToColor(Color.Named(nil), Color.Named(nil)), @"");
+}
+
+- (void)testHash {
+    XCTAssertEqual(ColorHash(Color.Red()), ColorHash(Color.Red()), @"");
+    XCTAssertEqual(ColorHash(Color.Gray(0.5)), ColorHash(Color.Gray(0.5)), @"");
+    XCTAssertEqual(ColorHash(Color.Other(1.0, 0.5, 0.25)), ColorHash(Color.Other(1.0, 0.5, 0.25)), @"");
+
+    XCTAssertTrue(ColorHash(Color.Red()) != ColorHash(Color.Green()), @"");
+    XCTAssertTrue(ColorHash(Color.Gray(0.5)) != ColorHash(Color.Gray(0.75)), @"");
+    XCTAssertTrue(ColorHash(Color.Other(1.0, 0.5, 0.25)) != ColorHash(Color.Other(0.25, 0.5, 1.0)), @"expected parameter order to affect the hash");
+
+    MulticolorT mc = Multicolor.TwoColor(Color.Red(), Color.Blue());
+    XCTAssertEqual(MulticolorHash(mc), MulticolorHash(Multicolor.TwoColor(Color.Red(), Color.Blue())), @"");
+}
+
+- (void)testHashIsConsistentWithEquality {
+    XCTAssertEqual(ColorHash(Color.Gray(0.0)), ColorHash(Color.Gray(-0.0)), @"");
+
+    NSString *name = [NSMutableString stringWithString:@"foobar"];
+    XCTAssertEqual(ColorHash(Color.Named(name)), ColorHash(Color.Named(@"foobar")), @"");
+    XCTAssertEqual(ColorHash(Color.Named(nil)), ColorHash(Color.Named(nil)), @"");
+}
+
+- (void)testEqualityIgnoresStructurePadding {
+    PaddedSample first, second;
+    memset(&first, 0xAA, sizeof(first));
+    memset(&second, 0x55, sizeof(second));
+
+    first.flag = second.flag = 'x';
+    first.value = second.value = 0.5;
+
+    MeasurementT a = Measurement.PaddedMeasurement(first);
+    MeasurementT b = Measurement.PaddedMeasurement(second);
+
+    XCTAssertTrue(MeasurementEqualToMeasurement(a, b), @"expected padding to be cleared when the value is created");
+    XCTAssertEqual(MeasurementHash(a), MeasurementHash(b), @"");
+
+    second.value = 0.25;
+    XCTAssertFalse(MeasurementEqualToMeasurement(a, Measurement.PaddedMeasurement(second)), @"");
+}
+
+- (void)testEqualityPerformance {
+    ColorT values[] = {
+        Color.Red(),
+        Color.Gray(0.5),
+        Color.Other(1.0, 0.5, 0.25),
+        Color.Other(1.0, 0.5, 0.5),
+    };
+
+    const size_t count = sizeof(values) / sizeof(*values);
+
+    // blocks can't capture arrays, only pointers to them
+    const ColorT *valuesPtr = values;
+
+    [self measureBlock:^{
+        NSUInteger equal = 0;
+
+        for (NSUInteger i = 0;i < 10000000;++i) {
+            if (ColorEqualToColor(valuesPtr[i % count], valuesPtr[(i / count) % count]))
+                ++equal;
+        }
+
+        XCTAssertEqual(equal, (NSUInteger)10000000 / count, @"");
+    }];
+}
+
 - (void)testMaximums {
     MaxConstructorsT v = MaxConstructors.MaxParams19(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18);
     XCTAssertEqual(v.tag, MaxParams19, @"");
@@ -0,0 +1,14 @@
+//
+//  EXTArenaCoroutineTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTArenaCoroutine.h"
+
+@interface EXTArenaCoroutineTest : XCTestCase
+
+@end
@@ -0,0 +1,224 @@
+//
+//  EXTArenaCoroutineTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTArenaCoroutineTest.h"
+#import "EXTMallocCounting.h"
+
+static const NSUInteger coroutineBenchmarkIterations = 100000;
+
+@implementation EXTArenaCoroutineTest
+
+- (void)testArenaCoroutine {
+    ext_arena *arena = ext_arenaCreate(0);
+
+    int (^counter)(int) = arenaCoroutine(arena, struct { int i; }, state, int limit)({
+        for (state->i = 0;state->i < limit;++state->i) {
+            yield state->i;
+        }
+
+        yield -1;
+    });
+
+    XCTAssertEqual(counter(2), 0, @"");
+    XCTAssertEqual(counter(2), 1, @"");
+    XCTAssertEqual(counter(2), -1, @"");
+    XCTAssertEqual(counter(2), 0, @"expected the coroutine to restart after finishing");
+
+    counter = nil;
+    ext_arenaDestroy(arena);
+}
+
+- (void)testArenaCoroutinesAreIndependent {
+    ext_arena *arena = ext_arenaCreate(0);
+    const char *words[] = { "foo", "buzz" };
+
+    char (^first)(void) = nil;
+    char (^second)(void) = nil;
+
+    for (size_t n = 0;n < 2;++n) {
+        const char *word = words[n];
+
+        char (^characters)(void) = arenaCoroutine(arena, struct { size_t i; }, state, void)({
+            for (;word[state->i] != '\0';++state->i) {
+                yield word[state->i];
+            }
+
+            yield (char)'\0';
+        });
+
+        if (n == 0)
+            first = characters;
+        else
+            second = characters;
+    }
+
+    XCTAssertEqual(first(), 'f', @"");
+    XCTAssertEqual(second(), 'b', @"");
+    XCTAssertEqual(first(), 'o', @"");
+    XCTAssertEqual(second(), 'u', @"");
+
+    first = nil;
+    second = nil;
+    ext_arenaDestroy(arena);
+}
+
+- (void)testArenaCoroutineWithoutMemory {
+    ext_arena *arena = ext_arenaCreate(0);
+
+    // far more state than can ever be allocated
+    int (^coroutine)(void) = arenaCoroutine(arena, struct { char bytes[SIZE_MAX >> 4]; }, state, void)({
+        yield (int)state->bytes[0];
+    });
+
+    XCTAssertNil(coroutine, @"");
+
+    ext_arenaDestroy(arena);
+}
+
+- (void)testArenaAllocation {
+    ext_arena *arena = ext_arenaCreate(256);
+    XCTAssertEqual(ext_arenaCapacity(arena), (size_t)256, @"");
+
+    char *a = ext_arenaAllocate(arena, 3, 1);
+    double *b = ext_arenaAllocate(arena, sizeof(double), __alignof__(double));
+
+    XCTAssertTrue(a != NULL, @"");
+    XCTAssertTrue(b != NULL, @"");
+    XCTAssertEqual((uintptr_t)b % __alignof__(double), (uintptr_t)0, @"");
+
+    void *large = ext_arenaAllocate(arena, 1024, 16);
+    XCTAssertTrue(large != NULL, @"");
+    XCTAssertTrue(ext_arenaCapacity(arena) > 1024, @"expected a larger chunk to be allocated");
+
+    size_t capacity = ext_arenaCapacity(arena);
+    ext_arenaReset(arena);
+
+    XCTAssertEqual(ext_arenaAllocate(arena, 3, 1), (void *)a, @"expected memory to be reused after a reset");
+    XCTAssertEqual(ext_arenaCapacity(arena), capacity, @"");
+
+    ext_arenaDestroy(arena);
+}
+
+- (void)testCapturingObjectsFallsBackToHeap {
+    ext_arena *arena = ext_arenaCreate(0);
+    __weak id weakObject = nil;
+
+    @autoreleasepool {
+        NSObject *object = [[NSObject alloc] init];
+        weakObject = object;
+
+        id (^objects)(void) = arenaCoroutine(arena, struct { int unused; }, state, void)({
+            yield (id)object;
+            yield (id)nil;
+        });
+
+        XCTAssertEqual(objects(), object, @"");
+        XCTAssertNil(objects(), @"");
+    }
+
+    @autoreleasepool {
+        XCTAssertNotNil(weakObject, @"the arena should keep the coroutine alive");
+    }
+
+    ext_arenaReset(arena);
+    XCTAssertNil(weakObject, @"resetting the arena should release the coroutine");
+
+    ext_arenaDestroy(arena);
+}
+
+- (void)testArenaCoroutineDoesNotAllocate {
+    ext_arena *arena = ext_arenaCreate(0);
+
+    void (^createCoroutines)(void) = ^{
+        for (NSUInteger n = 0;n < coroutineBenchmarkIterations;++n) {
+            int (^counter)(void) = arenaCoroutine(arena, struct { int i; }, state, void)({
+                for (state->i = 0;;++state->i) {
+                    yield state->i;
+                }
+            });
+
+            counter();
+            counter();
+        }
+    };
+
+    // make sure the arena has enough chunks, then start over
+    createCoroutines();
+    ext_arenaReset(arena);
+
+    NSUInteger mallocs = countMallocsInBlock(createCoroutines);
+    XCTAssertEqual(mallocs, (NSUInteger)0, @"creating coroutines from a warmed-up arena should never allocate memory");
+
+    ext_arenaDestroy(arena);
+}
+
+- (void)testHeapCoroutineAllocations {
+    NSUInteger mallocs = countMallocsInBlock(^{
+        for (NSUInteger n = 0;n < coroutineBenchmarkIterations;++n) {
+            @autoreleasepool {
+                __block int i;
+
+                int (^counter)(void) = coroutine(void)({
+                    for (i = 0;;++i) {
+                        yield i;
+                    }
+                });
+
+                counter();
+                counter();
+            }
+        }
+    });
+
+    // each coroutine copies its block and both of its __block variables to
+    // the heap, which arena coroutines avoid
+    XCTAssertTrue(mallocs >= coroutineBenchmarkIterations, @"expected heap coroutines to be copied to the heap");
+    XCTAssertTrue(mallocs <= 3 * coroutineBenchmarkIterations, @"heap coroutines should allocate at most three times each, but allocated %lu times", (unsigned long)mallocs);
+}
+
+- (void)testHeapCoroutinePerformance {
+    [self measureBlock:^{
+        for (NSUInteger n = 0;n < coroutineBenchmarkIterations;++n) {
+            @autoreleasepool {
+                __block int i;
+
+                int (^counter)(void) = coroutine(void)({
+                    for (i = 0;;++i) {
+                        yield i;
+                    }
+                });
+
+                counter();
+                counter();
+            }
+        }
+    }];
+}
+
+- (void)testArenaCoroutinePerformance {
+    ext_arena *arena = ext_arenaCreate(0);
+
+    [self measureBlock:^{
+        for (NSUInteger n = 0;n < coroutineBenchmarkIterations;++n) {
+            int (^counter)(void) = arenaCoroutine(arena, struct { int i; }, state, void)({
+                for (state->i = 0;;++state->i) {
+                    yield state->i;
+                }
+            });
+
+            counter();
+            counter();
+        }
+
+        ext_arenaReset(arena);
+    }];
+
+    ext_arenaDestroy(arena);
+}
+
+@end
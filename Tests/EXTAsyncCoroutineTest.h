@@ -0,0 +1,14 @@
+//
+//  EXTAsyncCoroutineTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTAsyncCoroutine.h"
+
+@interface EXTAsyncCoroutineTest : XCTestCase
+
+@end
@@ -0,0 +1,118 @@
+//
+//  EXTAsyncCoroutineTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTAsyncCoroutineTest.h"
+#import <stdatomic.h>
+
+@implementation EXTAsyncCoroutineTest
+
+- (void)testAwait {
+    EXTExecutor *executor = [[EXTExecutor alloc] initWithWorkerCount:2];
+
+    EXTCompletion *request = [[EXTCompletion alloc] init];
+    __block id response = nil;
+
+    EXTAsyncTask *task = [executor spawn:asyncCoroutine({
+        ext_await(request);
+        response = request.value;
+    })];
+
+    XCTAssertFalse(task.completion.completed, @"task should be waiting on the request");
+
+    XCTAssertTrue([request completeWithValue:@"foobar"], @"");
+    XCTAssertFalse([request completeWithValue:@"buzz"], @"a completion should only complete once");
+
+    [task.completion waitUntilCompleted];
+    XCTAssertEqualObjects(response, @"foobar", @"");
+}
+
+- (void)testAwaitCompletedTask {
+    EXTExecutor *executor = [[EXTExecutor alloc] initWithWorkerCount:2];
+
+    NSMutableArray *order = [NSMutableArray array];
+    NSLock *lock = [[NSLock alloc] init];
+
+    EXTAsyncTask *first = [executor spawn:asyncCoroutine({
+        [lock lock];
+        [order addObject:@1];
+        [lock unlock];
+    })];
+
+    EXTAsyncTask *second = [executor spawn:asyncCoroutine({
+        ext_await(first.completion);
+
+        [lock lock];
+        [order addObject:@2];
+        [lock unlock];
+
+        // awaiting something already completed should continue immediately
+        ext_await(first.completion);
+
+        [lock lock];
+        [order addObject:@3];
+        [lock unlock];
+    })];
+
+    [second.completion waitUntilCompleted];
+    XCTAssertEqualObjects(order, (@[ @1, @2, @3 ]), @"");
+}
+
+- (void)testAsyncYield {
+    EXTExecutor *executor = [[EXTExecutor alloc] initWithWorkerCount:1];
+
+    __block int i;
+    __block int count = 0;
+
+    EXTAsyncTask *task = [executor spawn:asyncCoroutine({
+        for (i = 0;i < 10;++i) {
+            ++count;
+            ext_asyncYield;
+        }
+    })];
+
+    [task.completion waitUntilCompleted];
+    XCTAssertEqual(count, 10, @"");
+}
+
+- (void)testConcurrentCoroutinesPerformance {
+    static const NSUInteger coroutineCount = 100000;
+    static const int yieldsPerCoroutine = 10;
+
+    EXTExecutor *executor = [EXTExecutor sharedExecutor];
+
+    [self measureBlock:^{
+        EXTCompletion *start = [[EXTCompletion alloc] init];
+        NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:coroutineCount];
+
+        __block atomic_long finished = 0;
+
+        for (NSUInteger i = 0;i < coroutineCount;++i) {
+            __block int j;
+
+            [tasks addObject:[executor spawn:asyncCoroutine({
+                ext_await(start);
+
+                for (j = 0;j < yieldsPerCoroutine;++j) {
+                    ext_asyncYield;
+                }
+
+                atomic_fetch_add(&finished, 1);
+            })]];
+        }
+
+        [start complete];
+
+        for (EXTAsyncTask *task in tasks) {
+            [task.completion waitUntilCompleted];
+        }
+
+        XCTAssertEqual(atomic_load(&finished), (long)coroutineCount, @"");
+    }];
+}
+
+@end
@@ -0,0 +1,14 @@
+//
+//  EXTChannelTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTChannel.h"
+
+@interface EXTChannelTest : XCTestCase
+
+@end
@@ -0,0 +1,193 @@
+//
+//  EXTChannelTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTChannelTest.h"
+#import "EXTAsyncCoroutine.h"
+#import "EXTCoroutine.h"
+#import <stdatomic.h>
+
+static const NSUInteger EXTChannelTestIterations = 1000000;
+
+@implementation EXTChannelTest
+
+- (void)testNonBlockingOperations {
+    ext_channel *channel = ext_channelCreate(ext_channelSingleProducerSingleConsumer, sizeof(int), 3, ext_channelWaitBlock);
+    XCTAssertTrue(channel != NULL, @"");
+    XCTAssertEqual(ext_channelCapacity(channel), (size_t)4, @"capacity should be rounded up to a power of two");
+
+    int value = 0;
+    XCTAssertEqual(ext_channelTryReceive(channel, &value), ext_channelWouldBlock, @"");
+
+    for (int i = 0;i < 4;++i) {
+        XCTAssertEqual(ext_channelTrySend(channel, &i), ext_channelSuccess, @"");
+    }
+
+    int extra = 4;
+    XCTAssertEqual(ext_channelTrySend(channel, &extra), ext_channelWouldBlock, @"a full channel should not accept more values");
+
+    XCTAssertEqual(ext_channelTryReceive(channel, &value), ext_channelSuccess, @"");
+    XCTAssertEqual(value, 0, @"");
+    XCTAssertEqual(ext_channelTrySend(channel, &extra), ext_channelSuccess, @"");
+
+    ext_channelClose(channel);
+    XCTAssertTrue(ext_channelIsClosed(channel), @"");
+    XCTAssertEqual(ext_channelTrySend(channel, &extra), ext_channelClosed, @"");
+
+    for (int i = 1;i <= 4;++i) {
+        XCTAssertEqual(ext_channelTryReceive(channel, &value), ext_channelSuccess, @"values sent before closing should still be received");
+        XCTAssertEqual(value, i, @"");
+    }
+
+    XCTAssertEqual(ext_channelTryReceive(channel, &value), ext_channelClosed, @"");
+    XCTAssertFalse(ext_channelReceive(channel, &value), @"");
+
+    ext_channelDestroy(channel);
+}
+
+- (void)testSingleProducerSingleConsumer {
+    ext_channel *channel = ext_channelCreate(ext_channelSingleProducerSingleConsumer, sizeof(NSUInteger), 64, ext_channelWaitBlock);
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        for (NSUInteger i = 0;i < EXTChannelTestIterations;++i) {
+            ext_channelSend(channel, &i);
+        }
+
+        ext_channelClose(channel);
+    });
+
+    NSUInteger expected = 0;
+    NSUInteger value;
+    while (ext_channelReceive(channel, &value)) {
+        if (value != expected) {
+            XCTFail(@"received %lu out of order, expected %lu", (unsigned long)value, (unsigned long)expected);
+            break;
+        }
+
+        ++expected;
+    }
+
+    XCTAssertEqual(expected, EXTChannelTestIterations, @"");
+    ext_channelDestroy(channel);
+}
+
+- (void)testMultipleProducerMultipleConsumer {
+    const NSUInteger producerCount = 4;
+    const NSUInteger consumerCount = 4;
+
+    ext_channel *channel = ext_channelCreate(ext_channelMultipleProducerMultipleConsumer, sizeof(NSUInteger), 64, ext_channelWaitBlock);
+
+    dispatch_group_t producers = dispatch_group_create();
+    dispatch_group_t consumers = dispatch_group_create();
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+
+    __block atomic_ulong sum = 0;
+    __block atomic_ulong count = 0;
+
+    for (NSUInteger i = 0;i < consumerCount;++i) {
+        dispatch_group_async(consumers, queue, ^{
+            NSUInteger value;
+            while (ext_channelReceive(channel, &value)) {
+                atomic_fetch_add(&sum, value);
+                atomic_fetch_add(&count, 1);
+            }
+        });
+    }
+
+    NSUInteger perProducer = EXTChannelTestIterations / producerCount;
+
+    for (NSUInteger i = 0;i < producerCount;++i) {
+        dispatch_group_async(producers, queue, ^{
+            for (NSUInteger value = 1;value <= perProducer;++value) {
+                ext_channelSend(channel, &value);
+            }
+        });
+    }
+
+    dispatch_group_wait(producers, DISPATCH_TIME_FOREVER);
+    ext_channelClose(channel);
+    dispatch_group_wait(consumers, DISPATCH_TIME_FOREVER);
+
+    XCTAssertEqual((NSUInteger)atomic_load(&count), perProducer * producerCount, @"");
+    XCTAssertEqual((NSUInteger)atomic_load(&sum), producerCount * perProducer * (perProducer + 1) / 2, @"");
+
+    ext_channelDestroy(channel);
+}
+
+- (void)testClosingWakesWaitingReceivers {
+    ext_channel *channel = ext_channelCreate(ext_channelMultipleProducerMultipleConsumer, sizeof(int), 4, ext_channelWaitBlock);
+    dispatch_semaphore_t finished = dispatch_semaphore_create(0);
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        int value;
+        XCTAssertFalse(ext_channelReceive(channel, &value), @"");
+        dispatch_semaphore_signal(finished);
+    });
+
+    [NSThread sleepForTimeInterval:0.05];
+    ext_channelClose(channel);
+
+    XCTAssertEqual(dispatch_semaphore_wait(finished, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0L, @"the receiver should have been woken up");
+    ext_channelDestroy(channel);
+}
+
+- (void)testCoroutinePipeline {
+    ext_channel *channel = ext_channelCreate(ext_channelSingleProducerSingleConsumer, sizeof(NSUInteger), 16, ext_channelWaitYield);
+    EXTExecutor *executor = [[EXTExecutor alloc] initWithWorkerCount:2];
+
+    __block NSUInteger i;
+    __block NSUInteger square;
+
+    // a generator coroutine feeding an asynchronous producer, which yields its
+    // worker whenever the consumer falls behind
+    int (^squares)(void) = coroutine(void)({
+        for (i = 1;;++i) {
+            yield (int)(i * i);
+        }
+    });
+
+    EXTAsyncTask *producer = [executor spawn:asyncCoroutine({
+        for (;;) {
+            square = (NSUInteger)squares();
+            if (square > 10000)
+                break;
+
+            while (ext_channelTrySend(channel, &square) == ext_channelWouldBlock) {
+                ext_asyncYield;
+            }
+        }
+
+        ext_channelClose(channel);
+    })];
+
+    NSMutableArray *received = [NSMutableArray array];
+    NSUInteger value;
+    while (ext_channelReceive(channel, &value)) {
+        [received addObject:@(value)];
+    }
+
+    [producer.completion waitUntilCompleted];
+
+    XCTAssertEqual(received.count, (NSUInteger)100, @"");
+    XCTAssertEqualObjects(received.lastObject, @10000, @"");
+
+    ext_channelDestroy(channel);
+}
+
+- (void)testSingleProducerSingleConsumerPerformance {
+    [self measureBlock:^{
+        [self testSingleProducerSingleConsumer];
+    }];
+}
+
+- (void)testMultipleProducerMultipleConsumerPerformance {
+    [self measureBlock:^{
+        [self testMultipleProducerMultipleConsumer];
+    }];
+}
+
+@end
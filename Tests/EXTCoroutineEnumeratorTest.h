@@ -0,0 +1,15 @@
+//
+//  EXTCoroutineEnumeratorTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTCoroutine.h"
+#import "EXTCoroutineEnumerator.h"
+
+@interface EXTCoroutineEnumeratorTest : XCTestCase
+
+@end
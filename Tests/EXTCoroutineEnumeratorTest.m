@@ -0,0 +1,141 @@
+//
+//  EXTCoroutineEnumeratorTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTCoroutineEnumeratorTest.h"
+
+static const NSUInteger EXTCoroutineEnumeratorTestIterations = 1000000;
+
+@implementation EXTCoroutineEnumeratorTest
+
+- (EXTCoroutineEnumerator *)enumeratorOfNumbersUpTo:(NSUInteger)limit batchSize:(NSUInteger)batchSize {
+    __block NSUInteger i;
+
+    return [[EXTCoroutineEnumerator alloc] initWithGenerator:batchCoroutine(__strong id)({
+        for (i = 0;i < limit;++i) {
+            batchYield @(i);
+        }
+    }) batchSize:batchSize];
+}
+
+- (void)testFastEnumeration {
+    NSMutableArray *numbers = [NSMutableArray array];
+
+    for (NSNumber *number in [self enumeratorOfNumbersUpTo:100 batchSize:16]) {
+        [numbers addObject:number];
+    }
+
+    XCTAssertEqual(numbers.count, (NSUInteger)100, @"");
+
+    [numbers enumerateObjectsUsingBlock:^(NSNumber *number, NSUInteger index, BOOL *stop){
+        XCTAssertEqual(number.unsignedIntegerValue, index, @"");
+    }];
+}
+
+- (void)testEmptyEnumeration {
+    EXTCoroutineEnumerator *enumerator = [self enumeratorOfNumbersUpTo:0 batchSize:16];
+
+    for (id obj in enumerator) {
+        XCTFail(@"should not have enumerated %@", obj);
+    }
+
+    XCTAssertNil([enumerator nextObject], @"");
+}
+
+- (void)testNextObject {
+    EXTCoroutineEnumerator *enumerator = [self enumeratorOfNumbersUpTo:5 batchSize:2];
+
+    XCTAssertEqualObjects([enumerator nextObject], @0, @"");
+    XCTAssertEqualObjects([enumerator nextObject], @1, @"");
+    XCTAssertEqualObjects([enumerator nextObject], @2, @"");
+    XCTAssertEqualObjects(enumerator.allObjects, (@[ @3, @4 ]), @"");
+    XCTAssertNil([enumerator nextObject], @"");
+}
+
+- (void)testFastEnumerationAfterNextObject {
+    EXTCoroutineEnumerator *enumerator = [self enumeratorOfNumbersUpTo:10 batchSize:4];
+
+    XCTAssertEqualObjects([enumerator nextObject], @0, @"");
+
+    NSMutableArray *rest = [NSMutableArray array];
+    for (NSNumber *number in enumerator) {
+        [rest addObject:number];
+    }
+
+    XCTAssertEqualObjects(rest, (@[ @1, @2, @3, @4, @5, @6, @7, @8, @9 ]), @"");
+    XCTAssertNil([enumerator nextObject], @"an enumerator should be exhausted after enumeration");
+}
+
+- (void)testBreakingOutOfEnumeration {
+    __block NSUInteger generated = 0;
+    __block NSUInteger i;
+
+    EXTCoroutineEnumerator *enumerator = [[EXTCoroutineEnumerator alloc] initWithGenerator:batchCoroutine(__strong id)({
+        for (i = 0;i < 100;++i) {
+            ++generated;
+            batchYield @(i);
+        }
+    }) batchSize:16];
+
+    for (NSNumber *number in enumerator) {
+        if (number.unsignedIntegerValue == 3)
+            break;
+    }
+
+    XCTAssertEqual(generated, (NSUInteger)16, @"only the first batch should have been generated");
+}
+
+- (void)testBatchIsReleased {
+    __weak id weakObject = nil;
+
+    @autoreleasepool {
+        __block BOOL yielded = NO;
+
+        EXTCoroutineEnumerator *enumerator = [[EXTCoroutineEnumerator alloc] initWithGenerator:batchCoroutine(__strong id)({
+            batchYield [[NSObject alloc] init];
+            yielded = YES;
+        }) batchSize:16];
+
+        @autoreleasepool {
+            for (id obj in enumerator) {
+                weakObject = obj;
+                XCTAssertNotNil(weakObject, @"the current batch should be retained");
+            }
+        }
+
+        XCTAssertTrue(yielded, @"");
+        XCTAssertNil(weakObject, @"the batch should be released once the next one is generated");
+    }
+}
+
+- (void)testCoroutineEnumerationPerformance {
+    [self measureBlock:^{
+        NSUInteger sum = 0;
+
+        for (NSNumber *number in [self enumeratorOfNumbersUpTo:EXTCoroutineEnumeratorTestIterations batchSize:64]) {
+            sum += number.unsignedIntegerValue;
+        }
+
+        XCTAssertEqual(sum, EXTCoroutineEnumeratorTestIterations * (EXTCoroutineEnumeratorTestIterations - 1) / 2, @"");
+    }];
+}
+
+- (void)testNextObjectEnumerationPerformance {
+    [self measureBlock:^{
+        EXTCoroutineEnumerator *enumerator = [self enumeratorOfNumbersUpTo:EXTCoroutineEnumeratorTestIterations batchSize:1];
+        NSUInteger sum = 0;
+
+        NSNumber *number;
+        while ((number = [enumerator nextObject])) {
+            sum += number.unsignedIntegerValue;
+        }
+
+        XCTAssertEqual(sum, EXTCoroutineEnumeratorTestIterations * (EXTCoroutineEnumeratorTestIterations - 1) / 2, @"");
+    }];
+}
+
+@end
@@ -9,6 +9,9 @@
 
 #import "EXTCoroutineTest.h"
 
+// the number of values produced by each of the pipeline benchmarks, which all
+// perform the same four-stage computation
+static const int EXTCoroutineTestPipelineLength = 1000000;
 
 @implementation EXTCoroutineTest
 
@@ -37,4 +40,262 @@
     XCTAssertEqual(myCoroutine(), 5, @"expected restarted coroutine call to yield 5");
 }
 
+- (void)testBatchYield {
+    __block int i;
+
+    size_t (^myCoroutine)(int *, size_t, int) = batchCoroutine(int, int limit)({
+        for (i = 0;i < limit;++i) {
+            if (i % 2)
+                batchYield i * 10;
+            else
+                batchYield i;
+        }
+    });
+
+    int buffer[3];
+
+    XCTAssertEqual(myCoroutine(buffer, 3, 5), (size_t)3, @"expected first batch to fill the buffer");
+    XCTAssertEqual(buffer[0], 0, @"");
+    XCTAssertEqual(buffer[1], 10, @"");
+    XCTAssertEqual(buffer[2], 2, @"");
+
+    XCTAssertEqual(myCoroutine(buffer, 3, 5), (size_t)2, @"expected second batch to contain the remaining values");
+    XCTAssertEqual(buffer[0], 30, @"");
+    XCTAssertEqual(buffer[1], 4, @"");
+
+    XCTAssertEqual(myCoroutine(buffer, 3, 5), (size_t)0, @"expected finished coroutine to produce no values");
+    XCTAssertEqual(myCoroutine(buffer, 3, 5), (size_t)3, @"expected finished coroutine to restart");
+    XCTAssertEqual(buffer[0], 0, @"");
+}
+
+- (void)testBatchForEach {
+    __block int i;
+
+    size_t (^myCoroutine)(int *, size_t) = batchCoroutine(int)({
+        for (i = 0;i < 10;++i) {
+            batchYield i;
+        }
+    });
+
+    int sum = 0;
+    batchForEach(int, value, 4, myCoroutine) {
+        sum += value;
+    }
+
+    XCTAssertEqual(sum, 45, @"expected every value to be visited once");
+
+    NSMutableArray *visited = [NSMutableArray array];
+    batchForEach(int, value, 4, myCoroutine) {
+        if (value == 1)
+            continue;
+
+        if (value == 6)
+            break;
+
+        [visited addObject:@(value)];
+    }
+
+    XCTAssertEqualObjects(visited, (@[ @0, @2, @3, @4, @5 ]), @"expected continue and break to behave as in any other loop");
+}
+
+- (void)testPipeline {
+    __block NSUInteger i;
+
+    size_t (^evenSquares)(NSUInteger *, size_t) = pipeline(NSUInteger, x, for (i = 0;;++i), i,
+        filter(x % 2 == 0),
+        map(x * x),
+        take(5)
+    );
+
+    NSMutableArray *values = [NSMutableArray array];
+    batchForEach(NSUInteger, square, 16, evenSquares) {
+        [values addObject:@(square)];
+    }
+
+    XCTAssertEqualObjects(values, (@[ @0, @4, @16, @36, @64 ]), @"");
+
+    [values removeAllObjects];
+    batchForEach(NSUInteger, square, 2, evenSquares) {
+        [values addObject:@(square)];
+    }
+
+    XCTAssertEqualObjects(values, (@[ @0, @4, @16, @36, @64 ]), @"expected the pipeline to restart after finishing");
+}
+
+- (void)testPipelineStagesRunInOrder {
+    __block int i;
+
+    size_t (^squaresOfEvens)(int *, size_t) = pipeline(int, x, for (i = 0;i < 10;++i), i,
+        map(x * x),
+        filter(x % 2 == 0)
+    );
+
+    size_t (^evensOfSquares)(int *, size_t) = pipeline(int, x, for (i = 0;i < 10;++i), i,
+        filter(x % 3 == 0),
+        map(x + 1)
+    );
+
+    int buffer[16];
+
+    XCTAssertEqual(squaresOfEvens(buffer, 16), (size_t)5, @"");
+    XCTAssertEqual(buffer[4], 64, @"");
+
+    XCTAssertEqual(evensOfSquares(buffer, 16), (size_t)4, @"");
+    XCTAssertEqual(buffer[0], 1, @"");
+    XCTAssertEqual(buffer[3], 10, @"");
+}
+
+- (void)testPipelineChunk {
+    __block int i;
+
+    size_t (^chunks)(int *, size_t) = pipeline(int, x, for (i = 0;i < 10;++i), i,
+        chunk(4)
+    );
+
+    int buffer[16];
+    XCTAssertEqual(chunks(buffer, 16), (size_t)4, @"");
+    XCTAssertEqual(buffer[0], 0, @"");
+    XCTAssertEqual(chunks(buffer, 16), (size_t)4, @"");
+    XCTAssertEqual(buffer[0], 4, @"");
+    XCTAssertEqual(chunks(buffer, 16), (size_t)2, @"");
+    XCTAssertEqual(buffer[1], 9, @"");
+    XCTAssertEqual(chunks(buffer, 16), (size_t)0, @"");
+}
+
+- (void)testYieldPerformance {
+    __block int i;
+
+    int (^myCoroutine)(void) = coroutine(void)({
+        for (i = 0;;++i) {
+            yield i;
+        }
+    });
+
+    [self measureBlock:^{
+        int sum = 0;
+        for (int j = 0;j < 1000000;++j) {
+            sum += myCoroutine();
+        }
+    }];
+}
+
+- (void)testBatchYieldPerformance {
+    __block int i;
+
+    size_t (^myCoroutine)(int *, size_t) = batchCoroutine(int)({
+        for (i = 0;i < 1000000;++i) {
+            batchYield i;
+        }
+    });
+
+    [self measureBlock:^{
+        int sum = 0;
+        batchForEach(int, value, 64, myCoroutine) {
+            sum += value;
+        }
+    }];
+}
+
+- (void)testHandWrittenLoopPerformance {
+    [self measureBlock:^{
+        long sum = 0;
+        int taken = 0;
+
+        for (int i = 0;i < EXTCoroutineTestPipelineLength * 4 && taken < EXTCoroutineTestPipelineLength;++i) {
+            int x = i;
+            if (x % 2 != 0)
+                continue;
+
+            x = x / 2 + 1;
+            if (x % 3 == 0)
+                continue;
+
+            ++taken;
+            sum += x;
+        }
+
+        XCTAssertTrue(sum > 0, @"");
+    }];
+}
+
+- (void)testPipelinePerformance {
+    __block int i;
+
+    size_t (^values)(int *, size_t) = pipeline(int, x, for (i = 0;i < EXTCoroutineTestPipelineLength * 4;++i), i,
+        filter(x % 2 == 0),
+        map(x / 2 + 1),
+        filter(x % 3 != 0),
+        take(EXTCoroutineTestPipelineLength)
+    );
+
+    [self measureBlock:^{
+        long sum = 0;
+        batchForEach(int, value, 64, values) {
+            sum += value;
+        }
+
+        XCTAssertTrue(sum > 0, @"");
+    }];
+}
+
+- (void)testChainedCoroutinePerformance {
+    [self measureBlock:^{
+        __block int i;
+        __block int evenValue;
+        __block int mappedValue;
+        __block int taken;
+
+        // each stage is a separate coroutine, which yields -1 when finished
+        int (^source)(void) = coroutine(void)({
+            for (i = 0;i < EXTCoroutineTestPipelineLength * 4;++i) {
+                yield i;
+            }
+
+            yield -1;
+        });
+
+        int (^evens)(void) = coroutine(void)({
+            while ((evenValue = source()) >= 0) {
+                if (evenValue % 2 == 0)
+                    yield evenValue;
+            }
+
+            yield -1;
+        });
+
+        int (^mapped)(void) = coroutine(void)({
+            while ((mappedValue = evens()) >= 0) {
+                yield mappedValue / 2 + 1;
+            }
+
+            yield -1;
+        });
+
+        int (^filtered)(void) = coroutine(void)({
+            while ((mappedValue = mapped()) >= 0) {
+                if (mappedValue % 3 != 0)
+                    yield mappedValue;
+            }
+
+            yield -1;
+        });
+
+        int (^take)(void) = coroutine(void)({
+            for (taken = 0;taken < EXTCoroutineTestPipelineLength;++taken) {
+                yield filtered();
+            }
+
+            yield -1;
+        });
+
+        long sum = 0;
+        int value;
+        while ((value = take()) >= 0) {
+            sum += value;
+        }
+
+        XCTAssertTrue(sum > 0, @"");
+    }];
+}
+
 @end
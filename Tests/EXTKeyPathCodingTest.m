@@ -8,6 +8,8 @@
 
 #import "EXTKeyPathCodingTest.h"
 
+static const NSUInteger EXTKeyPathCodingTestIterations = 1000000;
+
 // used to test refactoring also updating @keypath() uses
 @interface MyClass : NSObject
 
@@ -62,6 +64,48 @@
     XCTAssertEqualObjects(path, @"classProperty", @"");
 }
 
+- (void)testKeyPathIsCreatedOnce {
+    NSURL *URL = [NSURL URLWithString:@"http://www.google.com:8080/search?q=foo"];
+    NSString *firstPath = nil;
+
+    for (int i = 0;i < 2;++i) {
+        NSString *path = @keypath(URL.port.stringValue);
+        if (firstPath)
+            XCTAssertTrue(path == firstPath, @"expected the same string to be reused");
+
+        firstPath = path;
+    }
+}
+
+- (void)testKeyPathPerformance {
+    NSURL *URL = [NSURL URLWithString:@"http://www.google.com:8080/search?q=foo"];
+
+    [self measureBlock:^{
+        NSUInteger length = 0;
+
+        for (NSUInteger i = 0;i < EXTKeyPathCodingTestIterations;++i) {
+            NSString *path = @keypath(URL.port.stringValue);
+            length += path.length;
+        }
+
+        XCTAssertEqual(length, EXTKeyPathCodingTestIterations * 16, @"");
+    }];
+}
+
+- (void)testLiteralKeyPathPerformance {
+    // for comparison with -testKeyPathPerformance
+    [self measureBlock:^{
+        NSUInteger length = 0;
+
+        for (NSUInteger i = 0;i < EXTKeyPathCodingTestIterations;++i) {
+            NSString *path = @"port.stringValue";
+            length += path.length;
+        }
+
+        XCTAssertEqual(length, EXTKeyPathCodingTestIterations * 16, @"");
+    }];
+}
+
 - (void)testCollectionInstanceKeyPath {
 	MyClass *obj = [[MyClass alloc] init];
 	NSString * _Nonnull path = @collectionKeypath(obj.collection, MyClass.new, someUniqueProperty);
@@ -73,6 +117,28 @@
 	XCTAssertEqualObjects(path, @"collection.someUniqueProperty", @"");
 }
 
+- (void)testCollectionKeyPathIsCreatedOnce {
+	MyClass *obj = [[MyClass alloc] init];
+	NSString *instancePath = nil;
+	NSString *classPath = nil;
+
+	for (int i = 0;i < 2;++i) {
+		NSString *path = @collectionKeypath(obj.collection, MyClass.new, someUniqueProperty);
+		if (instancePath)
+			XCTAssertTrue(path == instancePath, @"expected the same string to be reused");
+
+		instancePath = path;
+
+		path = @collectionKeypath(MyClass.new, collection, MyClass.new, someUniqueProperty);
+		if (classPath)
+			XCTAssertTrue(path == classPath, @"expected the same string to be reused");
+
+		classPath = path;
+	}
+
+	XCTAssertEqualObjects(instancePath, classPath, @"");
+}
+
 @end
 
 @implementation MyClass
@@ -0,0 +1,14 @@
+//
+//  EXTKeyPathTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTKeyPath.h"
+
+@interface EXTKeyPathTest : XCTestCase
+
+@end
@@ -0,0 +1,326 @@
+//
+//  EXTKeyPathTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTKeyPathTest.h"
+
+static const NSUInteger EXTKeyPathTestIterations = 1000000;
+static const NSUInteger EXTKeyPathTestColumnCount = 100000;
+
+@interface KeyPathTestEmployee : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) NSInteger age;
+@property (nonatomic, assign) double salary;
+@property (nonatomic, assign, getter = isManager) BOOL manager;
+@property (nonatomic, assign) unsigned char level;
+@property (nonatomic, assign) NSRange range;
+@property (nonatomic, strong) KeyPathTestEmployee *boss;
+@end
+
+@interface KeyPathTestContractor : KeyPathTestEmployee
+@end
+
+@interface EXTKeyPathTest ()
+- (KeyPathTestEmployee *)employeeWithName:(NSString *)name age:(NSInteger)age;
+- (NSArray *)employeesForColumnTests;
+@end
+
+@implementation EXTKeyPathTest
+
+- (KeyPathTestEmployee *)employeeWithName:(NSString *)name age:(NSInteger)age {
+    KeyPathTestEmployee *employee = [[KeyPathTestEmployee alloc] init];
+    employee.name = name;
+    employee.age = age;
+    employee.salary = age * 1000.5;
+    return employee;
+}
+
+- (void)testObjectValues {
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    employee.boss = [self employeeWithName:@"Bob" age:50];
+
+    EXTKeyPath *keyPath = @compiledKeypath(employee.boss.name);
+    XCTAssertEqualObjects(keyPath.string, @"boss.name", @"");
+    XCTAssertEqualObjects([keyPath valueForObject:employee], @"Bob", @"");
+
+    keyPath = @compiledKeypath(employee.boss.name.length);
+    XCTAssertEqualObjects([keyPath valueForObject:employee], @3, @"");
+
+    XCTAssertNil([keyPath valueForObject:employee.boss], @"expected a nil intermediate value to produce nil");
+    XCTAssertNil([keyPath valueForObject:nil], @"");
+}
+
+- (void)testScalarValues {
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    employee.manager = YES;
+    employee.level = 200;
+
+    EXTKeyPath *agePath = @compiledKeypath(employee.age);
+    XCTAssertEqual([agePath integerValueForObject:employee], (NSInteger)30, @"");
+    XCTAssertEqual([agePath doubleValueForObject:employee], 30.0, @"");
+    XCTAssertEqualObjects([agePath valueForObject:employee], @30, @"");
+
+    EXTKeyPath *salaryPath = @compiledKeypath(employee.salary);
+    XCTAssertEqual([salaryPath doubleValueForObject:employee], 30015.0, @"");
+    XCTAssertEqual([salaryPath integerValueForObject:employee], (NSInteger)30015, @"");
+
+    EXTKeyPath *managerPath = [EXTKeyPath keyPathWithString:@"manager"];
+    XCTAssertTrue([managerPath boolValueForObject:employee], @"expected the is<Key> accessor to be found");
+    XCTAssertEqualObjects([managerPath valueForObject:employee], [employee valueForKey:@"manager"], @"");
+
+    EXTKeyPath *levelPath = @compiledKeypath(employee.level);
+    XCTAssertEqual([levelPath unsignedIntegerValueForObject:employee], (NSUInteger)200, @"");
+
+    // object values are converted by sending them a message
+    EXTKeyPath *namePath = [EXTKeyPath keyPathWithString:@"name"];
+    employee.name = @"42";
+    XCTAssertEqual([namePath integerValueForObject:employee], (NSInteger)42, @"");
+}
+
+- (void)testMatchesKeyValueCoding {
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    employee.range = NSMakeRange(5, 10);
+
+    // boxed structures
+    EXTKeyPath *keyPath = @compiledKeypath(employee.range);
+    XCTAssertEqualObjects([keyPath valueForObject:employee], [employee valueForKey:@"range"], @"");
+
+    // dictionaries
+    NSDictionary *dictionary = @{ @"count": @"foo", @"employee": employee };
+    keyPath = [EXTKeyPath keyPathWithString:@"employee.name"];
+    XCTAssertEqualObjects([keyPath valueForObject:dictionary], @"Alice", @"");
+
+    keyPath = [EXTKeyPath keyPathWithString:@"count"];
+    XCTAssertEqualObjects([keyPath valueForObject:dictionary], @"foo", @"expected -valueForKey: to be used instead of -count");
+
+    // collections
+    NSArray *employees = @[ employee, [self employeeWithName:@"Bob" age:50] ];
+    keyPath = [EXTKeyPath keyPathWithString:@"name"];
+    XCTAssertEqualObjects([keyPath valueForObject:employees], (@[ @"Alice", @"Bob" ]), @"");
+
+    // collection operators
+    keyPath = [EXTKeyPath keyPathWithString:@"@sum.age"];
+    XCTAssertEqual([keyPath integerValueForObject:employees], (NSInteger)80, @"");
+}
+
+- (void)testMultipleClasses {
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    KeyPathTestContractor *contractor = [[KeyPathTestContractor alloc] init];
+    contractor.age = 40;
+
+    EXTKeyPath *agePath = @compiledKeypath(employee.age);
+    EXTKeyPath *lengthPath = [EXTKeyPath keyPathWithString:@"length"];
+
+    // more classes than fit in the cache at once
+    for (int i = 0;i < 20;++i) {
+        XCTAssertEqual([agePath integerValueForObject:employee], (NSInteger)30, @"");
+        XCTAssertEqual([agePath integerValueForObject:contractor], (NSInteger)40, @"");
+        XCTAssertEqual([lengthPath integerValueForObject:@"foo"], (NSInteger)3, @"");
+        XCTAssertEqual([lengthPath integerValueForObject:[@"foo" mutableCopy]], (NSInteger)3, @"");
+        XCTAssertEqual([lengthPath integerValueForObject:[NSData dataWithBytes:"foobar" length:6]], (NSInteger)6, @"");
+    }
+}
+
+- (void)testConcurrentEvaluation {
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    KeyPathTestContractor *contractor = [[KeyPathTestContractor alloc] init];
+    contractor.age = 40;
+
+    EXTKeyPath *agePath = [EXTKeyPath keyPathWithString:@"age"];
+    __block BOOL failed = NO;
+
+    dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t thread){
+        for (NSUInteger i = 0;i < 10000;++i) {
+            KeyPathTestEmployee *object = ((i + thread) % 2 ? employee : contractor);
+            if ([agePath integerValueForObject:object] != object.age)
+                failed = YES;
+        }
+    });
+
+    XCTAssertFalse(failed, @"");
+}
+
+- (NSArray *)employeesForColumnTests {
+    NSMutableArray *employees = [NSMutableArray arrayWithCapacity:EXTKeyPathTestColumnCount];
+    KeyPathTestEmployee *boss = [self employeeWithName:@"Bob" age:50];
+
+    for (NSUInteger i = 0;i < EXTKeyPathTestColumnCount;++i) {
+        KeyPathTestEmployee *employee;
+
+        // runs of different classes
+        if ((i / 100) % 3 == 0) {
+            employee = [[KeyPathTestContractor alloc] init];
+            employee.age = (NSInteger)i;
+        } else {
+            employee = [self employeeWithName:@"Alice" age:(NSInteger)i];
+        }
+
+        employee.salary = i * 0.5;
+        employee.manager = (i % 7 == 0);
+
+        // some employees have no boss
+        if (i % 5 != 0)
+            employee.boss = boss;
+
+        [employees addObject:employee];
+    }
+
+    return employees;
+}
+
+- (void)testScalarColumns {
+    NSArray *employees = [self employeesForColumnTests];
+    NSUInteger count = employees.count;
+
+    NSInteger *ages = calloc(count, sizeof(*ages));
+    double *salaries = calloc(count, sizeof(*salaries));
+    BOOL *managers = calloc(count, sizeof(*managers));
+    NSUInteger *bossAges = calloc(count, sizeof(*bossAges));
+
+    [[EXTKeyPath keyPathWithString:@"age"] getIntegerValues:ages forObjects:employees];
+    [[EXTKeyPath keyPathWithString:@"salary"] getDoubleValues:salaries forObjects:employees];
+    [[EXTKeyPath keyPathWithString:@"manager"] getBoolValues:managers forObjects:employees];
+    [[EXTKeyPath keyPathWithString:@"boss.age"] getUnsignedIntegerValues:bossAges forObjects:employees];
+
+    for (NSUInteger i = 0;i < count;++i) {
+        XCTAssertEqual(ages[i], (NSInteger)i, @"");
+        XCTAssertEqual(salaries[i], i * 0.5, @"");
+        XCTAssertEqual(managers[i], (BOOL)(i % 7 == 0), @"");
+        XCTAssertEqual(bossAges[i], (NSUInteger)(i % 5 != 0 ? 50 : 0), @"");
+    }
+
+    free(ages);
+    free(salaries);
+    free(managers);
+    free(bossAges);
+}
+
+- (void)testObjectColumn {
+    NSArray *employees = [self employeesForColumnTests];
+    NSUInteger count = employees.count;
+
+    __strong id *names = (__strong id *)calloc(count, sizeof(*names));
+    [[EXTKeyPath keyPathWithString:@"boss.name"] getValues:names forObjects:employees];
+
+    for (NSUInteger i = 0;i < count;++i) {
+        XCTAssertEqualObjects(names[i], (i % 5 != 0 ? @"Bob" : nil), @"");
+    }
+
+    // existing values should be replaced
+    [[EXTKeyPath keyPathWithString:@"age"] getValues:names forObjects:employees];
+    XCTAssertEqualObjects(names[count - 1], @(count - 1), @"");
+
+    for (NSUInteger i = 0;i < count;++i) {
+        names[i] = nil;
+    }
+
+    free(names);
+}
+
+- (void)testColumnUsingKeyValueCoding {
+    NSArray *departments = @[
+        @[ [self employeeWithName:@"Alice" age:30], [self employeeWithName:@"Bob" age:50] ],
+        @[],
+        @[ [self employeeWithName:@"Carol" age:20] ]
+    ];
+
+    NSInteger totals[3] = { -1, -1, -1 };
+    [[EXTKeyPath keyPathWithString:@"@sum.age"] getIntegerValues:totals forObjects:departments];
+
+    XCTAssertEqual(totals[0], (NSInteger)80, @"");
+    XCTAssertEqual(totals[1], (NSInteger)0, @"");
+    XCTAssertEqual(totals[2], (NSInteger)20, @"");
+}
+
+- (void)testEmptyColumn {
+    [[EXTKeyPath keyPathWithString:@"age"] getIntegerValues:NULL forObjects:@[]];
+}
+
+- (void)testColumnPerformance {
+    NSArray *employees = [self employeesForColumnTests];
+    double *salaries = calloc(employees.count, sizeof(*salaries));
+
+    [self measureBlock:^{
+        EXTKeyPath *keyPath = @compiledKeypath(KeyPathTestEmployee.new, salary);
+        [keyPath getDoubleValues:salaries forObjects:employees];
+    }];
+
+    free(salaries);
+}
+
+- (void)testArrayValueForKeyPerformance {
+    // for comparison with -testColumnPerformance
+    NSArray *employees = [self employeesForColumnTests];
+    double *salaries = calloc(employees.count, sizeof(*salaries));
+
+    [self measureBlock:^{
+        NSArray *values = [employees valueForKey:@keypath(KeyPathTestEmployee.new, salary)];
+
+        NSUInteger i = 0;
+        for (NSNumber *value in values) {
+            salaries[i++] = value.doubleValue;
+        }
+    }];
+
+    free(salaries);
+}
+
+- (void)testEquality {
+    EXTKeyPath *first = [EXTKeyPath keyPathWithString:@"boss.name"];
+    EXTKeyPath *second = [EXTKeyPath keyPathWithString:@"boss.name"];
+
+    XCTAssertEqualObjects(first, second, @"");
+    XCTAssertEqual(first.hash, second.hash, @"");
+    XCTAssertFalse([first isEqual:[EXTKeyPath keyPathWithString:@"boss"]], @"");
+    XCTAssertTrue([first copy] == first, @"");
+}
+
+- (void)testCompiledKeyPathPerformance {
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    employee.boss = [self employeeWithName:@"Bob" age:50];
+
+    [self measureBlock:^{
+        NSInteger total = 0;
+
+        for (NSUInteger i = 0;i < EXTKeyPathTestIterations;++i) {
+            EXTKeyPath *keyPath = @compiledKeypath(employee.boss.age);
+            total += [keyPath integerValueForObject:employee];
+        }
+
+        XCTAssertEqual(total, (NSInteger)(50 * EXTKeyPathTestIterations), @"");
+    }];
+}
+
+- (void)testValueForKeyPathPerformance {
+    // for comparison with -testCompiledKeyPathPerformance
+    KeyPathTestEmployee *employee = [self employeeWithName:@"Alice" age:30];
+    employee.boss = [self employeeWithName:@"Bob" age:50];
+
+    [self measureBlock:^{
+        NSInteger total = 0;
+
+        for (NSUInteger i = 0;i < EXTKeyPathTestIterations;++i) {
+            total += [[employee valueForKeyPath:@keypath(employee.boss.age)] integerValue];
+        }
+
+        XCTAssertEqual(total, (NSInteger)(50 * EXTKeyPathTestIterations), @"");
+    }];
+}
+
+@end
+
+@implementation KeyPathTestEmployee
+@end
+
+@implementation KeyPathTestContractor
+
+// overridden so that contractors use a different accessor
+- (NSInteger)age {
+    return [super age];
+}
+
+@end
@@ -0,0 +1,15 @@
+//
+//  EXTMallocCounting.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Runs \a block, and returns the number of allocations made by this thread
+ * while it was executing.
+ */
+NSUInteger countMallocsInBlock (void (^block)(void));
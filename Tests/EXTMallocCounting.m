@@ -0,0 +1,36 @@
+//
+//  EXTMallocCounting.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTMallocCounting.h"
+#import <pthread.h>
+
+// the hook used by malloc stack logging, which is invoked for every allocation
+// and deallocation in any malloc zone
+typedef void (ext_mallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+extern ext_mallocLogger *malloc_logger;
+
+static const uint32_t ext_mallocLogTypeAllocate = 2;
+
+static pthread_t countedThread;
+static volatile NSUInteger mallocCount = 0;
+
+static void countMallocs (uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    if ((type & ext_mallocLogTypeAllocate) && pthread_equal(pthread_self(), countedThread))
+        ++mallocCount;
+}
+
+NSUInteger countMallocsInBlock (void (^block)(void)) {
+    countedThread = pthread_self();
+    mallocCount = 0;
+
+    malloc_logger = &countMallocs;
+    block();
+    malloc_logger = NULL;
+
+    return mallocCount;
+}
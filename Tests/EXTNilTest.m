@@ -10,6 +10,46 @@
 #import "EXTNilTest.h"
 #import "EXTRuntimeTestProtocol.h"
 
+typedef struct {
+    float x, y;
+} EXTNilTestFloatPair;
+
+typedef struct {
+    long long values[8];
+} EXTNilTestLargeStruct;
+
+typedef struct {
+    char c;
+    double d;
+} EXTNilTestMixedStruct;
+
+@interface EXTNilTestObject : NSObject
+- (EXTNilTestFloatPair)floatPairValue;
+- (EXTNilTestLargeStruct)largeStructValue;
+- (EXTNilTestMixedStruct)mixedStructValue;
+- (long double)longDoubleValue;
+@end
+
+@implementation EXTNilTestObject
+
+- (EXTNilTestFloatPair)floatPairValue {
+    return (EXTNilTestFloatPair){ 1, 2 };
+}
+
+- (EXTNilTestLargeStruct)largeStructValue {
+    return (EXTNilTestLargeStruct){ { 1, 2, 3, 4, 5, 6, 7, 8 } };
+}
+
+- (EXTNilTestMixedStruct)mixedStructValue {
+    return (EXTNilTestMixedStruct){ 'a', 1 };
+}
+
+- (long double)longDoubleValue {
+    return 1;
+}
+
+@end
+
 @implementation EXTNilTest
 
 - (void)testReturnValues {
@@ -33,6 +73,61 @@
     XCTAssertEqualObjects([arr[0] target], nil, @"EXTNil object properties should be preserved in a collection");
 }
 
+- (void)testAggregateReturnValues {
+    id obj = [EXTNil null];
+
+    // call each one twice, to go through both forwarding and the installed
+    // method
+    for (int i = 0;i < 2;++i) {
+        EXTNilTestFloatPair pair = [obj floatPairValue];
+        XCTAssertEqual(pair.x, 0.0f, @"");
+        XCTAssertEqual(pair.y, 0.0f, @"");
+
+        EXTNilTestLargeStruct large = [obj largeStructValue];
+        for (size_t j = 0;j < sizeof(large.values) / sizeof(*large.values);++j) {
+            XCTAssertEqual(large.values[j], 0LL, @"");
+        }
+
+        EXTNilTestMixedStruct mixed = [obj mixedStructValue];
+        XCTAssertEqual(mixed.c, (char)0, @"");
+        XCTAssertEqual(mixed.d, 0.0, @"");
+
+        XCTAssertTrue([obj longDoubleValue] == 0, @"");
+        XCTAssertTrue(NSEqualRanges([obj rangeOfString:@""], NSMakeRange(0, 0)), @"");
+    }
+}
+
+- (void)testRespondsToSelectorAfterResolution {
+    id obj = [EXTNil null];
+    [obj uppercaseString];
+
+    XCTAssertFalse([obj respondsToSelector:@selector(uppercaseString)], @"EXTNil should not respond to selectors it has resolved");
+}
+
+- (void)testMessagingNilPerformance {
+    id obj = nil;
+
+    [self measureBlock:^{
+        for (int i = 0;i < 1000000;++i) {
+            [obj length];
+            [obj doubleValue];
+            [obj rangeOfString:@""];
+        }
+    }];
+}
+
+- (void)testMessagingEXTNilPerformance {
+    id obj = [EXTNil null];
+
+    [self measureBlock:^{
+        for (int i = 0;i < 1000000;++i) {
+            [obj length];
+            [obj doubleValue];
+            [obj rangeOfString:@""];
+        }
+    }];
+}
+
 - (void)testKeyValueCoding {
     id obj = [EXTNil null];
     [obj setValue:@"foo" forKey:@"bar"];
@@ -8,6 +8,75 @@
 
 #import "EXTObjectiveCppCompileTest.h"
 
+// the umbrella header shouldn't define these very generic names
+#if defined(yield) || defined(coroutine) || defined(pipeline) || defined(await)
+#error "extobjc.h leaks unprefixed coroutine macros"
+#endif
+
+typedef struct {
+    char flag;
+    double value;
+} CppPaddedSample;
+
+ADT(CppShape,
+    constructor(CppNoShape),
+    constructor(CppCircle, double radius),
+    constructor(CppLabel, __unsafe_unretained NSString *text),
+    constructor(CppSample, CppPaddedSample sample)
+);
+
 @implementation EXTObjectiveCppCompileTest
 
+- (void)testOnExitInline {
+    NSMutableString *str = [@"foo" mutableCopy];
+    unsigned executed = 0;
+
+    {
+        @onExitInline {
+            ++executed;
+            [str appendString:@"bar"];
+        };
+
+        @onExitInline {
+            XCTAssertEqual(executed, 0U, @"lexical ordering of @onExitInline guards is not correct!");
+        };
+    }
+
+    XCTAssertEqual(executed, 1U, @"@onExitInline guard should capture variables by reference");
+    XCTAssertEqualObjects(str, @"foobar", @"'bar' should've been appended to 'foo' at the end of the previous scope");
+}
+
+- (void)testADT {
+    CppShapeT circle = CppShape.CppCircle(2.0);
+    XCTAssertEqual(circle.tag, CppCircle, @"");
+    XCTAssertEqualWithAccuracy(circle.radius, 2.0, 0.0001, @"");
+    XCTAssertTrue(CppShapeEqualToCppShape(circle, CppShape.CppCircle(2.0)), @"");
+    XCTAssertFalse(CppShapeEqualToCppShape(circle, CppShape.CppNoShape()), @"");
+    XCTAssertEqual(CppShapeHash(circle), CppShapeHash(CppShape.CppCircle(2.0)), @"");
+
+    CppShapeT label = CppShape.CppLabel(@"foo");
+    XCTAssertEqualObjects(NSStringFromCppShape(label), @"CppLabel { text = foo }", @"");
+
+    CppPaddedSample sample;
+    memset(&sample, 0xAA, sizeof(sample));
+    sample.flag = 'x';
+    sample.value = 0.5;
+
+    CppShapeT sampleShape = CppShape.CppSample(sample);
+    XCTAssertEqual(sampleShape.sample.value, 0.5, @"");
+
+    NSString *name = nil;
+    ext_match (label) {
+        default:
+            break;
+
+        // in C++, only the last clause can bind parameters
+        ext_with(CppLabel, text)
+            name = text;
+            break;
+    }
+
+    XCTAssertEqualObjects(name, @"foo", @"");
+}
+
 @end
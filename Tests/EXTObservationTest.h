@@ -0,0 +1,15 @@
+//
+//  EXTObservationTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTKeyPathCoding.h"
+#import "EXTObservation.h"
+
+@interface EXTObservationTest : XCTestCase
+
+@end
@@ -0,0 +1,269 @@
+//
+//  EXTObservationTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTObservationTest.h"
+
+static const NSUInteger EXTObservationTestIterations = 100000;
+
+@interface ObservationTestPerson : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) NSInteger age;
+@property (nonatomic, assign) double height;
+@property (nonatomic, assign, getter = isAdmin) BOOL admin;
+@end
+
+@interface ObservationTestEmployee : ObservationTestPerson
+@property (nonatomic, assign) NSUInteger ageSetCount;
+@end
+
+@interface ObservationTestKVOObserver : NSObject
+@property (nonatomic, assign) NSUInteger count;
+@end
+
+@interface EXTObservationTest ()
+- (void)measureObservationWithObserverCount:(NSUInteger)observerCount;
+- (void)measureKeyValueObservingWithObserverCount:(NSUInteger)observerCount;
+@end
+
+@implementation EXTObservationTest
+
+- (void)testObjectProperty {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+    person.name = @"foo";
+
+    __block NSUInteger count = 0;
+    NSUInteger token = ext_addPropertyObserver(person, @keypath(person.name), ^(const ext_propertyChange *change){
+        XCTAssertEqual(change->object, person, @"");
+        XCTAssertEqualObjects(change->key, @"name", @"");
+        XCTAssertEqualObjects(ext_propertyChangeOldValue(change, __unsafe_unretained id), @"foo", @"");
+        XCTAssertEqualObjects(ext_propertyChangeNewValue(change, __unsafe_unretained id), @"bar", @"");
+        ++count;
+    });
+
+    XCTAssertTrue(token != 0, @"");
+
+    person.name = @"bar";
+    XCTAssertEqual(count, (NSUInteger)1, @"");
+    XCTAssertEqualObjects(person.name, @"bar", @"");
+
+    XCTAssertTrue(ext_removePropertyObserver(person, token), @"");
+    XCTAssertFalse(ext_removePropertyObserver(person, token), @"");
+
+    person.name = @"foo";
+    XCTAssertEqual(count, (NSUInteger)1, @"expected no notification after removing the observer");
+}
+
+- (void)testScalarProperties {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+    person.age = 20;
+
+    __block NSInteger oldAge = 0;
+    __block NSInteger newAge = 0;
+    ext_addPropertyObserver(person, @keypath(person.age), ^(const ext_propertyChange *change){
+        oldAge = ext_propertyChangeOldValue(change, NSInteger);
+        newAge = ext_propertyChangeNewValue(change, NSInteger);
+    });
+
+    __block double newHeight = 0;
+    ext_addPropertyObserver(person, @keypath(person.height), ^(const ext_propertyChange *change){
+        XCTAssertEqual(strcmp(change->type, @encode(double)), 0, @"");
+        newHeight = ext_propertyChangeNewValue(change, double);
+    });
+
+    __block BOOL newAdmin = NO;
+    ext_addPropertyObserver(person, @keypath(person.admin), ^(const ext_propertyChange *change){
+        newAdmin = ext_propertyChangeNewValue(change, BOOL);
+    });
+
+    person.age = 21;
+    XCTAssertEqual(oldAge, (NSInteger)20, @"");
+    XCTAssertEqual(newAge, (NSInteger)21, @"");
+
+    person.height = 1.75;
+    XCTAssertEqual(newHeight, 1.75, @"");
+    XCTAssertEqual(person.height, 1.75, @"");
+
+    person.admin = YES;
+    XCTAssertTrue(newAdmin, @"");
+}
+
+- (void)testOnlyObservedObjectsNotify {
+    ObservationTestPerson *observed = [[ObservationTestPerson alloc] init];
+    ObservationTestPerson *unobserved = [[ObservationTestPerson alloc] init];
+
+    __block NSUInteger count = 0;
+    ext_addPropertyObserver(observed, @keypath(observed.age), ^(const ext_propertyChange *change){
+        ++count;
+    });
+
+    unobserved.age = 5;
+    XCTAssertEqual(unobserved.age, (NSInteger)5, @"");
+    XCTAssertEqual(count, (NSUInteger)0, @"");
+
+    observed.name = @"foo";
+    XCTAssertEqual(count, (NSUInteger)0, @"expected only the observed property to notify");
+
+    observed.age = 5;
+    XCTAssertEqual(count, (NSUInteger)1, @"");
+}
+
+- (void)testObserverOrder {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+    NSMutableArray *calls = [NSMutableArray array];
+
+    for (NSUInteger i = 0;i < 3;++i) {
+        ext_addPropertyObserver(person, @keypath(person.age), ^(const ext_propertyChange *change){
+            [calls addObject:@(i)];
+        });
+    }
+
+    person.age = 1;
+    XCTAssertEqualObjects(calls, (@[ @0, @1, @2 ]), @"");
+}
+
+- (void)testSubclassOverridingSetter {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+    ObservationTestEmployee *employee = [[ObservationTestEmployee alloc] init];
+
+    __block NSUInteger personCount = 0;
+    ext_addPropertyObserver(person, @keypath(person.age), ^(const ext_propertyChange *change){
+        ++personCount;
+    });
+
+    __block NSUInteger employeeCount = 0;
+    ext_addPropertyObserver(employee, @keypath(employee.age), ^(const ext_propertyChange *change){
+        XCTAssertEqual(ext_propertyChangeNewValue(change, NSInteger), (NSInteger)40, @"");
+        ++employeeCount;
+    });
+
+    employee.age = 40;
+    XCTAssertEqual(employee.ageSetCount, (NSUInteger)1, @"");
+    XCTAssertEqual(employeeCount, (NSUInteger)1, @"expected observers to be notified once");
+    XCTAssertEqual(personCount, (NSUInteger)0, @"");
+
+    person.age = 30;
+    XCTAssertEqual(personCount, (NSUInteger)1, @"");
+    XCTAssertEqual(employeeCount, (NSUInteger)1, @"");
+}
+
+- (void)testKeyValueObservingStillWorks {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+    ObservationTestKVOObserver *observer = [[ObservationTestKVOObserver alloc] init];
+
+    __block NSUInteger count = 0;
+    ext_addPropertyObserver(person, @keypath(person.age), ^(const ext_propertyChange *change){
+        ++count;
+    });
+
+    [person addObserver:observer forKeyPath:@keypath(person.age) options:0 context:NULL];
+
+    person.age = 1;
+    XCTAssertEqual(count, (NSUInteger)1, @"");
+    XCTAssertEqual(observer.count, (NSUInteger)1, @"");
+
+    [person removeObserver:observer forKeyPath:@keypath(person.age)];
+
+    person.age = 2;
+    XCTAssertEqual(count, (NSUInteger)2, @"");
+}
+
+- (void)testInvalidProperties {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+
+    XCTAssertThrows(ext_addPropertyObserver(person, @"nonexistent", ^(const ext_propertyChange *change){}), @"");
+    XCTAssertThrows(ext_addPropertyObserver(person, @keypath(person.description), ^(const ext_propertyChange *change){}), @"expected readonly properties to be rejected");
+}
+
+- (void)measureObservationWithObserverCount:(NSUInteger)observerCount {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+
+    __block NSUInteger count = 0;
+    for (NSUInteger i = 0;i < observerCount;++i) {
+        ext_addPropertyObserver(person, @keypath(person.age), ^(const ext_propertyChange *change){
+            ++count;
+        });
+    }
+
+    [self measureBlock:^{
+        count = 0;
+
+        for (NSUInteger i = 0;i < EXTObservationTestIterations;++i) {
+            person.age = (NSInteger)i;
+        }
+
+        XCTAssertEqual(count, EXTObservationTestIterations * observerCount, @"");
+    }];
+}
+
+- (void)measureKeyValueObservingWithObserverCount:(NSUInteger)observerCount {
+    ObservationTestPerson *person = [[ObservationTestPerson alloc] init];
+    NSMutableArray *observers = [NSMutableArray array];
+
+    for (NSUInteger i = 0;i < observerCount;++i) {
+        ObservationTestKVOObserver *observer = [[ObservationTestKVOObserver alloc] init];
+        [person addObserver:observer forKeyPath:@keypath(person.age) options:NSKeyValueObservingOptionOld | NSKeyValueObservingOptionNew context:NULL];
+        [observers addObject:observer];
+    }
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0;i < EXTObservationTestIterations;++i) {
+            person.age = (NSInteger)i;
+        }
+    }];
+
+    for (ObservationTestKVOObserver *observer in observers) {
+        [person removeObserver:observer forKeyPath:@keypath(person.age)];
+    }
+}
+
+- (void)testObservationPerformanceWithOneObserver {
+    [self measureObservationWithObserverCount:1];
+}
+
+- (void)testObservationPerformanceWithTenObservers {
+    [self measureObservationWithObserverCount:10];
+}
+
+- (void)testObservationPerformanceWithHundredObservers {
+    [self measureObservationWithObserverCount:100];
+}
+
+- (void)testKeyValueObservingPerformanceWithOneObserver {
+    // for comparison with -testObservationPerformanceWithOneObserver
+    [self measureKeyValueObservingWithObserverCount:1];
+}
+
+- (void)testKeyValueObservingPerformanceWithTenObservers {
+    [self measureKeyValueObservingWithObserverCount:10];
+}
+
+- (void)testKeyValueObservingPerformanceWithHundredObservers {
+    [self measureKeyValueObservingWithObserverCount:100];
+}
+
+@end
+
+@implementation ObservationTestPerson
+@end
+
+@implementation ObservationTestEmployee
+
+- (void)setAge:(NSInteger)age {
+    ++self.ageSetCount;
+    [super setAge:age];
+}
+
+@end
+
+@implementation ObservationTestKVOObserver
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context {
+    ++self.count;
+}
+
+@end
@@ -8,6 +8,9 @@
 //
 
 #import "EXTScopeTest.h"
+#import "EXTMallocCounting.h"
+
+static const NSUInteger scopeBenchmarkIterations = 1000000;
 
 @interface EXTScopeTest ()
 - (void)nestedAppend:(NSMutableString *)str;
@@ -166,6 +169,122 @@
     XCTAssertEqualObjects(str, @"foobar", @"'bar' should've been appended to 'foo' at the end of a called method that threw an exception");
 }
 
+- (void)testOnExitInline {
+    __block unsigned executed = 0;
+
+    for (unsigned i = 1;i <= 4;++i) {
+        @onExitInline {
+            executed += i;
+        };
+
+        if (i > 3)
+            break;
+
+        if (i % 2 == 0)
+            continue;
+    }
+
+    XCTAssertEqual(executed, 10U, @"onExitInline blocks should be executed on loop iterations, even when break or continue is used");
+
+    __block unsigned lastBlockEntered = 0;
+    {
+        @onExitInline {
+            XCTAssertEqual(lastBlockEntered, 2U, @"lexical ordering of @onExitInline blocks is not correct!");
+            lastBlockEntered = 1;
+        };
+
+        @onExitInline {
+            XCTAssertEqual(lastBlockEntered, 0U, @"lexical ordering of @onExitInline blocks is not correct!");
+            lastBlockEntered = 2;
+        };
+    }
+
+    XCTAssertEqual(lastBlockEntered, 1U, @"lexical ordering of @onExitInline blocks is not correct, or cleanup blocks did not execute at all!");
+
+    __block BOOL cleanupBlockRun = NO;
+    @try {
+        @onExitInline {
+            cleanupBlockRun = YES;
+        };
+
+        [NSException raise:@"EXTScopeTestException" format:@"test exception for @onExitInline cleanup in @try"];
+    } @catch (NSException *exception) {
+        XCTAssertEqualObjects([exception name], @"EXTScopeTestException", @"unexpected exception %@ thrown", exception);
+    }
+
+    XCTAssertTrue(cleanupBlockRun, @"@onExitInline block was not run when an exception was thrown");
+}
+
+- (void)testOnExitInlineDoesNotAllocate {
+    NSObject *obj = [[NSObject alloc] init];
+
+    NSUInteger mallocs = countMallocsInBlock(^{
+        __block NSUInteger count = 0;
+
+        for (NSUInteger i = 0;i < 100;++i) {
+            @onExitInline {
+                if (obj)
+                    ++count;
+            };
+        }
+    });
+
+    XCTAssertEqual(mallocs, (NSUInteger)0, @"@onExitInline should never allocate memory");
+}
+
+- (void)testOnExitAllocations {
+    NSObject *obj = [[NSObject alloc] init];
+
+    NSUInteger mallocs = countMallocsInBlock(^{
+        __block NSUInteger count = 0;
+
+        for (NSUInteger i = 0;i < scopeBenchmarkIterations;++i) {
+            @onExit {
+                if (obj)
+                    ++count;
+            };
+        }
+    });
+
+    // each scope copies its cleanup block to the heap, and the first copy
+    // also moves 'count' there
+    XCTAssertTrue(mallocs <= scopeBenchmarkIterations + 1, @"@onExit should allocate at most once per scope, but allocated %lu times", (unsigned long)mallocs);
+}
+
+- (void)testOnExitPerformance {
+    NSObject *obj = [[NSObject alloc] init];
+
+    [self measureBlock:^{
+        __block NSUInteger count = 0;
+
+        for (NSUInteger i = 0;i < scopeBenchmarkIterations;++i) {
+            @onExit {
+                if (obj)
+                    ++count;
+            };
+        }
+
+        XCTAssertEqual(count, scopeBenchmarkIterations, @"");
+    }];
+}
+
+- (void)testOnExitInlinePerformance {
+    NSObject *obj = [[NSObject alloc] init];
+
+    [self measureBlock:^{
+        __block NSUInteger count = 0;
+
+        for (NSUInteger i = 0;i < scopeBenchmarkIterations;++i) {
+            @onExitInline {
+                if (obj)
+                    ++count;
+            };
+        }
+
+        XCTAssertEqual(count, scopeBenchmarkIterations, @"");
+    }];
+}
+
 - (void)testWeakifyUnsafeifyStrongify {
     void (^verifyMemoryManagement)(void);
 
@@ -0,0 +1,14 @@
+//
+//  EXTStreamReaderTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import "EXTStreamReader.h"
+
+@interface EXTStreamReaderTest : XCTestCase
+
+@end
@@ -0,0 +1,207 @@
+//
+//  EXTStreamReaderTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTStreamReaderTest.h"
+#import <errno.h>
+#import <fcntl.h>
+#import <unistd.h>
+
+static const NSUInteger streamBenchmarkLineCount = 1000000;
+
+@interface EXTStreamReaderTest ()
+@property (nonatomic, copy) NSString *path;
+
+- (void)writeString:(NSString *)string;
+- (void)writeBenchmarkFile;
+- (NSArray *)stringsFromGenerator:(ext_sliceGenerator)generator;
+@end
+
+@implementation EXTStreamReaderTest
+
+- (void)setUp {
+    [super setUp];
+
+    NSString *filename = [NSString stringWithFormat:@"EXTStreamReaderTest-%@", [NSUUID UUID].UUIDString];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:filename];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:NULL];
+    [super tearDown];
+}
+
+- (void)writeString:(NSString *)string {
+    XCTAssertTrue([string writeToFile:self.path atomically:NO encoding:NSUTF8StringEncoding error:NULL], @"");
+}
+
+- (NSArray *)stringsFromGenerator:(ext_sliceGenerator)generator {
+    NSMutableArray *strings = [NSMutableArray array];
+
+    ext_slice slice;
+    while (generator(&slice)) {
+        NSString *string = [[NSString alloc] initWithBytes:slice.bytes length:slice.length encoding:NSUTF8StringEncoding];
+        [strings addObject:string];
+    }
+
+    return strings;
+}
+
+- (void)testLinesFromDescriptor {
+    [self writeString:@"foo\r\nbar\n\nthis line is longer than the buffer"];
+
+    int fd = open(self.path.fileSystemRepresentation, O_RDONLY);
+    XCTAssertTrue(fd >= 0, @"");
+
+    ext_streamReader *reader = ext_streamReaderCreateWithDescriptor(fd, 4);
+    ext_sliceGenerator lines = ext_streamReaderLines(reader);
+
+    NSArray *expected = @[ @"foo", @"bar", @"", @"this line is longer than the buffer" ];
+    XCTAssertEqualObjects([self stringsFromGenerator:lines], expected, @"");
+
+    ext_slice slice;
+    XCTAssertFalse(lines(&slice), @"expected the reader to stay exhausted");
+    XCTAssertEqual(ext_streamReaderError(reader), 0, @"");
+
+    ext_streamReaderDestroy(reader);
+    close(fd);
+}
+
+- (void)testLinesFromMappedFile {
+    [self writeString:@"foo\nbar\n"];
+
+    ext_streamReader *reader = ext_streamReaderCreateWithMappedFile(self.path.fileSystemRepresentation);
+    XCTAssertTrue(reader != NULL, @"");
+
+    NSArray *expected = @[ @"foo", @"bar" ];
+    XCTAssertEqualObjects([self stringsFromGenerator:ext_streamReaderLines(reader)], expected, @"");
+
+    ext_streamReaderDestroy(reader);
+}
+
+- (void)testEmptyMappedFile {
+    [self writeString:@""];
+
+    ext_streamReader *reader = ext_streamReaderCreateWithMappedFile(self.path.fileSystemRepresentation);
+    XCTAssertTrue(reader != NULL, @"");
+
+    ext_slice slice;
+    XCTAssertFalse(ext_streamReaderLines(reader)(&slice), @"");
+
+    ext_streamReaderDestroy(reader);
+}
+
+- (void)testMissingMappedFile {
+    XCTAssertTrue(ext_streamReaderCreateWithMappedFile("/nonexistent/file") == NULL, @"");
+    XCTAssertEqual(errno, ENOENT, @"");
+}
+
+- (void)testTokens {
+    [self writeString:@"foo,bar,,buzz"];
+
+    ext_streamReader *reader = ext_streamReaderCreateWithMappedFile(self.path.fileSystemRepresentation);
+
+    NSArray *expected = @[ @"foo", @"bar", @"", @"buzz" ];
+    XCTAssertEqualObjects([self stringsFromGenerator:ext_streamReaderTokens(reader, ',')], expected, @"");
+
+    ext_streamReaderDestroy(reader);
+}
+
+- (void)testRecords {
+    [self writeString:@"abcdefghij"];
+
+    int fd = open(self.path.fileSystemRepresentation, O_RDONLY);
+    ext_streamReader *reader = ext_streamReaderCreateWithDescriptor(fd, 2);
+
+    NSArray *expected = @[ @"abcd", @"efgh", @"ij" ];
+    XCTAssertEqualObjects([self stringsFromGenerator:ext_streamReaderRecords(reader, 4)], expected, @"");
+
+    ext_streamReaderDestroy(reader);
+    close(fd);
+}
+
+- (void)testHeaderFollowedByRecords {
+    [self writeString:@"3\nfoobarbaz"];
+
+    ext_streamReader *reader = ext_streamReaderCreateWithMappedFile(self.path.fileSystemRepresentation);
+
+    ext_slice header;
+    XCTAssertTrue(ext_streamReaderLines(reader)(&header), @"");
+    XCTAssertEqual(header.length, (size_t)1, @"");
+
+    NSArray *expected = @[ @"foo", @"bar", @"baz" ];
+    XCTAssertEqualObjects([self stringsFromGenerator:ext_streamReaderRecords(reader, 3)], expected, @"");
+
+    ext_streamReaderDestroy(reader);
+}
+
+- (void)writeBenchmarkFile {
+    NSMutableString *contents = [NSMutableString string];
+    for (NSUInteger i = 0;i < streamBenchmarkLineCount;++i) {
+        [contents appendFormat:@"%lu some log message\n", (unsigned long)i];
+    }
+
+    [self writeString:contents];
+}
+
+- (void)testDescriptorLinePerformance {
+    [self writeBenchmarkFile];
+
+    [self measureBlock:^{
+        int fd = open(self.path.fileSystemRepresentation, O_RDONLY);
+        ext_streamReader *reader = ext_streamReaderCreateWithDescriptor(fd, 0);
+        ext_sliceGenerator lines = ext_streamReaderLines(reader);
+
+        NSUInteger count = 0;
+        ext_slice line;
+        while (lines(&line)) {
+            ++count;
+        }
+
+        XCTAssertEqual(count, streamBenchmarkLineCount, @"");
+
+        ext_streamReaderDestroy(reader);
+        close(fd);
+    }];
+}
+
+- (void)testMappedFileLinePerformance {
+    [self writeBenchmarkFile];
+
+    [self measureBlock:^{
+        ext_streamReader *reader = ext_streamReaderCreateWithMappedFile(self.path.fileSystemRepresentation);
+        ext_sliceGenerator lines = ext_streamReaderLines(reader);
+
+        NSUInteger count = 0;
+        ext_slice line;
+        while (lines(&line)) {
+            ++count;
+        }
+
+        XCTAssertEqual(count, streamBenchmarkLineCount, @"");
+        ext_streamReaderDestroy(reader);
+    }];
+}
+
+- (void)testFoundationLinePerformance {
+    [self writeBenchmarkFile];
+
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSString *contents = [NSString stringWithContentsOfFile:self.path encoding:NSUTF8StringEncoding error:NULL];
+
+            __block NSUInteger count = 0;
+            [contents enumerateLinesUsingBlock:^(NSString *line, BOOL *stop){
+                ++count;
+            }];
+
+            XCTAssertEqual(count, streamBenchmarkLineCount, @"");
+        }
+    }];
+}
+
+@end
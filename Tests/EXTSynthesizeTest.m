@@ -10,6 +10,12 @@
 #import "EXTSynthesizeTest.h"
 #import "EXTSynthesize.h"
 
+static const NSUInteger EXTSynthesizeTestThreads = 8;
+static const NSUInteger EXTSynthesizeTestIterations = 100000;
+
+// used for comparison with properties synthesized by @synthesizeAssociation
+static void *EXTSynthesizeTestAssociatedObjectKey = &EXTSynthesizeTestAssociatedObjectKey;
+
 @interface NSObject (EXTSynthesizeTest)
 @property (nonatomic, unsafe_unretained) id testNonatomicAssignProperty;
 @property (unsafe_unretained) id testAtomicAssignProperty;
@@ -19,6 +25,12 @@
 
 @property (nonatomic, copy) id testNonatomicCopyProperty;
 @property (copy) id testAtomicCopyProperty;
+
+@property (nonatomic, assign) NSInteger testIntegerProperty;
+@property (nonatomic, assign) double testDoubleProperty;
+@property (nonatomic, assign, getter = isTestBoolProperty) BOOL testBoolProperty;
+@property (assign) NSRange testStructProperty;
+@property (nonatomic, strong) NSNumber *testBoxedIntegerProperty;
 @end
 
 @implementation NSObject (EXTSynthesizeTest)
@@ -28,6 +40,11 @@
 @synthesizeAssociation(NSObject, testAtomicRetainProperty);
 @synthesizeAssociation(NSObject, testNonatomicCopyProperty);
 @synthesizeAssociation(NSObject, testAtomicCopyProperty);
+@synthesizeAssociation(NSObject, testIntegerProperty);
+@synthesizeAssociation(NSObject, testDoubleProperty);
+@synthesizeAssociation(NSObject, testBoolProperty);
+@synthesizeAssociation(NSObject, testStructProperty);
+@synthesizeAssociation(NSObject, testBoxedIntegerProperty);
 @end
 
 @implementation EXTSynthesizeTest
@@ -117,4 +134,205 @@
 	XCTAssertEqualObjects(owner.testAtomicRetainProperty, value2, @"");
 }
 
+- (void)testScalarProperties {
+	NSObject *owner = [[NSObject alloc] init];
+
+	XCTAssertEqual(owner.testIntegerProperty, (NSInteger)0, @"");
+	XCTAssertEqual(owner.testDoubleProperty, 0.0, @"");
+	XCTAssertFalse(owner.testBoolProperty, @"");
+
+	owner.testIntegerProperty = -42;
+	owner.testDoubleProperty = 3.5;
+	owner.testBoolProperty = YES;
+
+	XCTAssertEqual(owner.testIntegerProperty, (NSInteger)-42, @"");
+	XCTAssertEqual(owner.testDoubleProperty, 3.5, @"");
+	XCTAssertTrue(owner.isTestBoolProperty, @"");
+
+	owner.testIntegerProperty = NSIntegerMax;
+	XCTAssertEqual(owner.testIntegerProperty, NSIntegerMax, @"");
+	XCTAssertEqual(owner.testDoubleProperty, 3.5, @"");
+}
+
+- (void)testStructProperties {
+	NSObject *owner = [[NSObject alloc] init];
+
+	NSRange range = owner.testStructProperty;
+	XCTAssertEqual(range.location, (NSUInteger)0, @"");
+	XCTAssertEqual(range.length, (NSUInteger)0, @"");
+
+	owner.testStructProperty = NSMakeRange(5, 10);
+	XCTAssertTrue(NSEqualRanges(owner.testStructProperty, NSMakeRange(5, 10)), @"");
+
+	owner.testNonatomicRetainProperty = @"foobar";
+	XCTAssertTrue(NSEqualRanges(owner.testStructProperty, NSMakeRange(5, 10)), @"");
+	XCTAssertEqualObjects(owner.testNonatomicRetainProperty, @"foobar", @"");
+}
+
+- (void)testScalarPropertiesAreIndependentPerOwner {
+	NSObject *firstOwner = [[NSObject alloc] init];
+	NSObject *secondOwner = [[NSObject alloc] init];
+
+	firstOwner.testIntegerProperty = 1;
+	secondOwner.testIntegerProperty = 2;
+
+	XCTAssertEqual(firstOwner.testIntegerProperty, (NSInteger)1, @"");
+	XCTAssertEqual(secondOwner.testIntegerProperty, (NSInteger)2, @"");
+}
+
+- (void)testScalarMethodTypes {
+	Method getter = class_getInstanceMethod([NSObject class], @selector(testStructProperty));
+	Method setter = class_getInstanceMethod([NSObject class], @selector(setTestStructProperty:));
+
+	XCTAssertTrue(getter != NULL, @"");
+	XCTAssertTrue(setter != NULL, @"");
+
+	char returnType[64];
+	method_getReturnType(getter, returnType, sizeof(returnType));
+	XCTAssertEqual(strcmp(returnType, @encode(NSRange)), 0, @"");
+
+	char argumentType[64];
+	method_getArgumentType(setter, 2, argumentType, sizeof(argumentType));
+	XCTAssertEqual(strcmp(argumentType, @encode(NSRange)), 0, @"");
+}
+
+- (void)testScalarPerformance {
+	NSObject *owner = [[NSObject alloc] init];
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0;i < EXTSynthesizeTestIterations;++i) {
+			owner.testIntegerProperty = (NSInteger)i;
+			XCTAssertEqual(owner.testIntegerProperty, (NSInteger)i, @"");
+		}
+	}];
+}
+
+- (void)testBoxedScalarPerformance {
+	// for comparison with -testScalarPerformance
+	NSObject *owner = [[NSObject alloc] init];
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0;i < EXTSynthesizeTestIterations;++i) {
+			@autoreleasepool {
+				owner.testBoxedIntegerProperty = [NSNumber numberWithInteger:(NSInteger)i];
+				XCTAssertEqual(owner.testBoxedIntegerProperty.integerValue, (NSInteger)i, @"");
+			}
+		}
+	}];
+}
+
+- (void)testGroupsArePerClassAndFile {
+	ext_associationGroup *group = ext_associationGroupForClass([NSObject class], __FILE__);
+
+	XCTAssertTrue(group != NULL, @"");
+	XCTAssertEqual(ext_associationGroupForClass([NSObject class], __FILE__), group, @"");
+	XCTAssertTrue(ext_associationGroupForClass([NSString class], __FILE__) != group, @"");
+	XCTAssertTrue(ext_associationGroupForClass([NSObject class], "EXTSynthesizeOtherFile.m") != group, @"");
+}
+
+- (void)testStrongValuesReleasedWithOwner {
+	__weak id weakRetainedValue = nil;
+	__weak id weakCopiedValue = nil;
+
+	@autoreleasepool {
+		NSObject *owner = [[NSObject alloc] init];
+
+		owner.testNonatomicRetainProperty = [@"foobar" mutableCopy];
+		weakRetainedValue = owner.testNonatomicRetainProperty;
+
+		owner.testAtomicCopyProperty = [@"bardoo" mutableCopy];
+		weakCopiedValue = owner.testAtomicCopyProperty;
+
+		XCTAssertNotNil(weakRetainedValue, @"");
+		XCTAssertNotNil(weakCopiedValue, @"");
+	}
+
+	XCTAssertNil(weakRetainedValue, @"");
+	XCTAssertNil(weakCopiedValue, @"");
+}
+
+- (void)testReplacedValuesReleased {
+	NSObject *owner = [[NSObject alloc] init];
+
+	__weak id weakValue = nil;
+
+	@autoreleasepool {
+		owner.testAtomicRetainProperty = [@"foobar" mutableCopy];
+		weakValue = owner.testAtomicRetainProperty;
+		XCTAssertNotNil(weakValue, @"");
+
+		owner.testAtomicRetainProperty = nil;
+	}
+
+	XCTAssertNil(weakValue, @"");
+	XCTAssertNil(owner.testAtomicRetainProperty, @"");
+}
+
+- (void)testValuesAreIndependentPerOwner {
+	NSObject *firstOwner = [[NSObject alloc] init];
+	NSObject *secondOwner = [[NSObject alloc] init];
+
+	firstOwner.testNonatomicRetainProperty = @"foobar";
+	XCTAssertNil(secondOwner.testNonatomicRetainProperty, @"");
+
+	secondOwner.testNonatomicRetainProperty = @"bardoo";
+	XCTAssertEqualObjects(firstOwner.testNonatomicRetainProperty, @"foobar", @"");
+	XCTAssertEqualObjects(secondOwner.testNonatomicRetainProperty, @"bardoo", @"");
+}
+
+- (void)testConcurrentAccess {
+	NSObject *sharedOwner = [[NSObject alloc] init];
+	NSArray *values = @[ @"foo", @"bar", @"baz" ];
+
+	dispatch_apply(EXTSynthesizeTestThreads, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t thread){
+		for (NSUInteger i = 0;i < EXTSynthesizeTestIterations / 10;++i) {
+			@autoreleasepool {
+				NSObject *owner = [[NSObject alloc] init];
+				owner.testAtomicRetainProperty = [values objectAtIndex:i % values.count];
+				XCTAssertEqualObjects(owner.testAtomicRetainProperty, [values objectAtIndex:i % values.count], @"");
+
+				sharedOwner.testAtomicRetainProperty = [values objectAtIndex:(i + thread) % values.count];
+				XCTAssertTrue([values containsObject:sharedOwner.testAtomicRetainProperty], @"");
+			}
+		}
+	});
+}
+
+- (void)testContendedAccessPerformance {
+	NSMutableArray *owners = [NSMutableArray array];
+	for (NSUInteger i = 0;i < EXTSynthesizeTestThreads;++i) {
+		[owners addObject:[[NSObject alloc] init]];
+	}
+
+	[self measureBlock:^{
+		dispatch_apply(EXTSynthesizeTestThreads, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t thread){
+			NSObject *owner = [owners objectAtIndex:thread];
+
+			for (NSUInteger i = 0;i < EXTSynthesizeTestIterations;++i) {
+				owner.testNonatomicRetainProperty = owners;
+				XCTAssertTrue(owner.testNonatomicRetainProperty == owners, @"");
+			}
+		});
+	}];
+}
+
+- (void)testContendedAssociatedObjectPerformance {
+	// for comparison with -testContendedAccessPerformance
+	NSMutableArray *owners = [NSMutableArray array];
+	for (NSUInteger i = 0;i < EXTSynthesizeTestThreads;++i) {
+		[owners addObject:[[NSObject alloc] init]];
+	}
+
+	[self measureBlock:^{
+		dispatch_apply(EXTSynthesizeTestThreads, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t thread){
+			NSObject *owner = [owners objectAtIndex:thread];
+
+			for (NSUInteger i = 0;i < EXTSynthesizeTestIterations;++i) {
+				objc_setAssociatedObject(owner, EXTSynthesizeTestAssociatedObjectKey, owners, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+				XCTAssertTrue(objc_getAssociatedObject(owner, EXTSynthesizeTestAssociatedObjectKey) == owners, @"");
+			}
+		});
+	}];
+}
+
 @end
@@ -0,0 +1,15 @@
+//
+//  EXTUnownedTest.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import "EXTUnowned.h"
+
+@interface EXTUnownedTest : XCTestCase
+
+@end
@@ -0,0 +1,181 @@
+//
+//  EXTUnownedTest.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTUnownedTest.h"
+
+static const size_t concurrentIterations = 64;
+static const NSUInteger callbacksPerIteration = 10000;
+
+@interface UnownedTestDeallocObject : NSObject
+@property (nonatomic, copy) void (^deallocBlock)(void);
+@end
+
+@implementation EXTUnownedTest
+
+- (void)testUnownedifyStrongifyUnowned {
+    NSString *foo = [@"foo" mutableCopy];
+    NSString *bar = [@"bar" mutableCopy];
+
+    void *fooPtr = &foo;
+
+    @unownedify(foo, bar);
+
+    BOOL (^matchesFooOrBar)(NSString *) = ^ BOOL (NSString *str){
+        @strongifyUnowned(bar, foo);
+
+        XCTAssertEqualObjects(foo, @"foo", @"");
+        XCTAssertEqualObjects(bar, @"bar", @"");
+        XCTAssertTrue(fooPtr != &foo, @"Address of 'foo' within block should be different from its address outside the block");
+
+        return [foo isEqual:str] || [bar isEqual:str];
+    };
+
+    XCTAssertTrue(matchesFooOrBar(@"foo"), @"");
+    XCTAssertTrue(matchesFooOrBar(@"bar"), @"");
+    XCTAssertFalse(matchesFooOrBar(@"buzz"), @"");
+}
+
+- (void)testNil {
+    id foo = nil;
+    @unownedify(foo);
+
+    id (^block)(void) = ^{
+        @strongifyUnowned(foo);
+        return foo;
+    };
+
+    XCTAssertNil(block(), @"");
+}
+
+- (void)testStaleReference {
+    ext_unownedReference reference;
+    ext_unownedReference secondReference;
+
+    @autoreleasepool {
+        NSObject *obj __attribute__((objc_precise_lifetime)) = [[NSObject alloc] init];
+
+        reference = ext_makeUnownedReference(obj);
+        secondReference = ext_makeUnownedReference(obj);
+
+        XCTAssertEqual(reference.token, secondReference.token, @"all unowned references to an object should share one token");
+        XCTAssertEqual(ext_copyUnownedReferenceObject(&reference, NO), obj, @"");
+    }
+
+    XCTAssertNil(ext_copyUnownedReferenceObject(&reference, NO), @"unowned reference should be invalidated when its object is deallocated");
+    XCTAssertNil(ext_copyUnownedReferenceObject(&secondReference, NO), @"unowned reference should be invalidated when its object is deallocated");
+}
+
+- (void)testAccessDuringDealloc {
+    __block BOOL accessed = NO;
+    __block id objectDuringDealloc = self;
+
+    @autoreleasepool {
+        UnownedTestDeallocObject *obj = [[UnownedTestDeallocObject alloc] init];
+        ext_unownedReference reference = ext_makeUnownedReference(obj);
+
+        // @strongifyUnowned would trap in debug builds
+        obj.deallocBlock = ^{
+            accessed = YES;
+            objectDuringDealloc = ext_copyUnownedReferenceObject(&reference, NO);
+        };
+    }
+
+    XCTAssertTrue(accessed, @"");
+    XCTAssertNil(objectDuringDealloc, @"unowned reference should be invalidated once its object begins deallocating");
+}
+
+- (void)testReusedAddress {
+    ext_unownedReference reference;
+
+    @autoreleasepool {
+        NSObject *obj __attribute__((objc_precise_lifetime)) = [[NSObject alloc] init];
+        reference = ext_makeUnownedReference(obj);
+    }
+
+    // objects are likely to be allocated at the address just freed, and may
+    // reuse its token
+    for (NSUInteger i = 0;i < 100;++i) {
+        NSObject *obj = [[NSObject alloc] init];
+        ext_unownedReference newReference = ext_makeUnownedReference(obj);
+
+        XCTAssertNil(ext_copyUnownedReferenceObject(&reference, NO), @"");
+        XCTAssertEqual(ext_copyUnownedReferenceObject(&newReference, NO), obj, @"");
+    }
+}
+
+- (void)testConcurrentDeallocation {
+    dispatch_apply(concurrentIterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration){
+        for (NSUInteger i = 0;i < callbacksPerIteration / 10;++i) {
+            ext_unownedReference reference;
+            dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+
+            @autoreleasepool {
+                NSObject *obj = [[NSObject alloc] init];
+                reference = ext_makeUnownedReference(obj);
+
+                dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                    id strongObj = ext_copyUnownedReferenceObject(&reference, NO);
+                    XCTAssertTrue(strongObj == nil || [strongObj isKindOfClass:[NSObject class]], @"");
+
+                    dispatch_semaphore_signal(semaphore);
+                });
+            }
+
+            dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+        }
+    });
+}
+
+- (void)testWeakCapturePerformance {
+    NSObject *obj = [[NSObject alloc] init];
+
+    [self measureBlock:^{
+        dispatch_apply(concurrentIterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration){
+            @weakify(obj);
+
+            void (^callback)(void) = [^{
+                @strongify(obj);
+                [obj self];
+            } copy];
+
+            for (NSUInteger i = 0;i < callbacksPerIteration;++i) {
+                callback();
+            }
+        });
+    }];
+}
+
+- (void)testUnownedCapturePerformance {
+    NSObject *obj = [[NSObject alloc] init];
+
+    [self measureBlock:^{
+        dispatch_apply(concurrentIterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration){
+            @unownedify(obj);
+
+            void (^callback)(void) = [^{
+                @strongifyUnowned(obj);
+                [obj self];
+            } copy];
+
+            for (NSUInteger i = 0;i < callbacksPerIteration;++i) {
+                callback();
+            }
+        });
+    }];
+}
+
+@end
+
+@implementation UnownedTestDeallocObject
+
+- (void)dealloc {
+    if (self.deallocBlock)
+        self.deallocBlock();
+}
+
+@end
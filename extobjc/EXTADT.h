@@ -27,9 +27,25 @@
  *  in with the enum value of the constructor used to create the value.
  *  - A function NSStringFromName(), which will convert an ADT value into
  *  a human-readable string.
+ *  - A function NameWriteDescription(), which writes the same description as
+ *  a null-terminated UTF-8 string into a buffer of a given length, truncating
+ *  it if necessary, and returns the length of the whole description (like \c
+ *  snprintf()). Unless the value contains objects, this does not allocate any
+ *  memory, so it's suitable for logging at high rates.
  *  - A function NameEqualToName(), which determines whether two ADT values are
  *  equal. For the purposes of the check, object parameters are compared with \c
- *  isEqual:.
+ *  isEqual:, floating-point parameters with \c ==, and all other parameters
+ *  bytewise. The comparison for each parameter is chosen at compile-time.
+ *  - A function NameHash(), which returns a hash code for an ADT value that is
+ *  consistent with NameEqualToName(). Object parameters are hashed with \c
+ *  -hash, and all other parameters with a fast non-cryptographic mixing
+ *  function. Hash codes are not stable across processes.
+ *  - Enum values NameSize and NameAlignment, which are the size and alignment
+ *  of NameT, for use in constant expressions (like static assertions that guard
+ *  the memory footprint of a type). See also #CompactADT and #PackedADT.
+ *  - A structure type NameArrayT, which is a growable array of ADT values
+ *  stored as columns (a "structure of arrays"), along with functions to
+ *  manipulate it. See below for details.
  *  - And, for each constructor Cons:
  *      - An enum value Cons, which can be used to refer to that data constructor.
  *      - A function Name.Cons(...), which accepts the parameters of the
@@ -74,6 +90,93 @@ ColorT Color.Blue ();
 ColorT Color.Gray (double alpha);
 ColorT Color.Other (double r, double g, double b);
 
+ * @endcode
+ *
+ * NameArrayT keeps a separate column for each parameter of each constructor,
+ * so that loops over all of the values created with a particular constructor
+ * only touch the data they need, don't need to branch on the tag, and can be
+ * vectorized. The columns for constructor Cons are available through the
+ * structure member of the same name, along with their \c count, and each
+ * column is named after the index of its parameter (\c v0, \c v1, etc.). The
+ * elements of each column can be read with the parameter's name:
+ *
+ * @code
+
+ColorArrayT *colors = ColorArrayCreate();
+ColorArrayAppend(colors, Color.Gray(0.5));
+ColorArrayAppend(colors, Color.Other(1.0, 0.5, 0.25));
+
+double totalRed = 0;
+for (size_t i = 0;i < colors->Other.count;++i) {
+    totalRed += colors->Other.v0[i].r;
+}
+
+ColorArrayDestroy(colors);
+
+ * @endcode
+ *
+ * The following functions are also generated for NameArrayT:
+ *
+ *  - NameArrayCreate() and NameArrayDestroy(), to allocate and free an
+ *  array.
+ *  - NameArrayCount(), which returns the number of values in the array.
+ *  - NameArrayAppend(), which adds a value to the end of the array, and returns
+ *  \c NO if memory could not be allocated.
+ *  - NameArrayGet(), which reconstructs the value at an index.
+ *  - NameArrayFilter(), which removes every value for which a block returns \c
+ *  NO, preserving the order of the remaining values.
+ *  - NameArrayRemoveAll(), which removes every value, but keeps the memory for
+ *  the columns.
+ *  - NameArrayCompact(), which frees any memory not currently needed by the
+ *  array.
+ *
+ * Arrays of ADT values can also be archived into a flat binary format, which
+ * can be read in place (e.g., from a memory-mapped file) without any decoding.
+ * The following are generated for this purpose:
+ *
+ *  - A structure type NameRecordT, which is the layout of each value in an
+ *  archive. Records are laid out like #PackedADT values, with a one-byte tag
+ *  followed by the parameters (in little-endian byte order), and parameters can
+ *  be read from them by name.
+ *  - A function NameArchive(), which archives an array of values into an \c
+ *  NSData object. The archive begins with a header identifying the version of
+ *  the format and the definition of the ADT, followed by a record for each
+ *  value.
+ *  - A function NameArchiveRecords(), which returns a pointer to the records
+ *  within an archive (and sets the number of records), or \c NULL if the
+ *  archive is invalid or was created with a different definition of the ADT.
+ *  - A function NameFromRecord(), which converts a record back into an ADT
+ *  value, suitable for comparing with NameEqualToName() or hashing.
+ *
+ * Object parameters cannot be stored in records, and are nil when read from
+ * them. Instead, they're saved after the records with \c NSKeyedArchiver, using
+ * secure coding (so they need to support \c NSSecureCoding).
+ * NameArchiveObjects() unarchives them all at once, given the set of classes
+ * which the objects may be instances of, returning an array that contains an
+ * array of objects for each record (or nil, if the archive doesn't contain any
+ * objects, or contains an object of any other class). Passing a record's array
+ * of objects to NameFromRecord() will fill in its object parameters. The
+ * decoded values do not retain their objects, so the array must be kept alive
+ * for as long as they're in use.
+ *
+ * Any other parameters, including non-object pointers like <tt>char *</tt>,
+ * are copied into records bitwise. A pointer is therefore archived as a raw
+ * address, which is meaningless in any other process (or after the memory it
+ * points to is freed), so ADTs with pointer parameters should only be archived
+ * if those pointers are \c NULL or are never read from the archive.
+ *
+ * @code
+
+NSData *data = ColorArchive(colors, count);
+
+size_t recordCount;
+const ColorRecordT *records = ColorArchiveRecords(data.bytes, data.length, &recordCount);
+
+for (size_t i = 0;i < recordCount;++i) {
+    if (records[i].tag == Gray)
+        NSLog(@"%f", records[i].alpha);
+}
+
  * @endcode
  *
  * @note Each constructor parameter must have a name that is unique among all of
@@ -97,6 +200,133 @@ ColorT Color.Other (double r, double g, double b);
  * will behave correctly.
  */
 #define ADT(NAME, ...) \
+    ADT_define_(NAME, /* default tag type */, ADT_payload_, /* no attributes */, __VA_ARGS__)
+
+/**
+ * Creates an algebraic data type like #ADT, but with a tag only one byte wide,
+ * instead of the size of an \c int. (Since an ADT can have at most nineteen
+ * data constructors, one byte is always the narrowest type that can hold the
+ * tag.) The payload is laid out normally, so this saves space when the payload
+ * is small or has loose alignment requirements.
+ *
+ * @code
+
+CompactADT(Token,
+    constructor(EndOfFile),
+    constructor(Character, char c),
+    constructor(Integer, int16_t i)
+);
+
+// one byte for the tag, one byte of padding, and the int16_t (instead of
+// eight bytes with ADT())
+_Static_assert(TokenSize == 4, "");
+
+ * @endcode
+ */
+#define CompactADT(NAME, ...) \
+    ADT_define_(NAME, : uint8_t, ADT_payload_, /* no attributes */, __VA_ARGS__)
+
+/**
+ * Creates an algebraic data type like #CompactADT, and also packs the tag and
+ * the parameters of each data constructor together without any padding, so
+ * that the size of each value is one byte more than the size of its largest
+ * constructor's parameters. This is useful for storing large arrays of small
+ * ADT values.
+ *
+ * Parameters will usually be misaligned, which is fine for accessing them
+ * directly (e.g., "token.i"), but pointers to them must not be dereferenced.
+ * The functions generated for the ADT take care of this, and the compiler will
+ * warn about taking the address of a misaligned member.
+ *
+ * @code
+
+PackedADT(Token,
+    constructor(EndOfFile),
+    constructor(Character, char c),
+    constructor(Integer, int16_t i)
+);
+
+_Static_assert(TokenSize == 3, "");
+_Static_assert(TokenAlignment == 1, "");
+
+ * @endcode
+ */
+#define PackedADT(NAME, ...) \
+    ADT_define_(NAME, : uint8_t, ADT_packedpayload_, __attribute__((packed)), __VA_ARGS__)
+
+/**
+ * Branches on the data constructor used to create the ADT value \a VALUE, which
+ * is evaluated only once. This compiles to a \c switch statement on the value's
+ * tag, so the body should consist of #ext_with clauses (and, optionally, a \c
+ * default label) for each data constructor.
+ *
+ * @code
+
+ext_match (color) {
+    ext_with(Red)
+        return @"red";
+
+    ext_with(Gray, alpha)
+        return (alpha > 0.5 ? @"light gray" : @"dark gray");
+
+    ext_with(Other, r, g, b) {
+        NSUInteger components = (r > 0) + (g > 0) + (b > 0);
+        return [NSString stringWithFormat:@"%lu components", (unsigned long)components];
+    }
+
+    default:
+        return @"something else";
+}
+
+ * @endcode
+ *
+ * @note As with any \c switch, execution falls through from one clause to the
+ * next unless it ends with \c break or \c return. Without a \c default label,
+ * the compiler will warn about any data constructors that aren't handled.
+ *
+ * @warning \c continue must not be used directly within the body of #ext_match,
+ * since it would only exit the match, instead of continuing an enclosing loop.
+ */
+#define ext_match(VALUE) \
+    /* this loop runs exactly once, and only exists to declare a variable */ \
+    for (__typeof__(VALUE) ext_matchValue_ = (VALUE), *ext_matchOnce_ = &ext_matchValue_; ext_matchOnce_; ext_matchOnce_ = NULL) \
+        switch (ext_matchValue_.tag)
+
+/**
+ * Begins a clause of an #ext_match for data constructor \a CONS. Any further
+ * arguments are names of the constructor's parameters, which are declared as
+ * local variables holding the parameter values from the value being matched.
+ * Parameters can be bound in any order, and unneeded ones can be omitted.
+ *
+ * @note C++ doesn't allow a jump to bypass the initialization of a variable, so
+ * in Objective-C++ only the last clause of an #ext_match may bind parameters.
+ */
+#define ext_with(...) \
+    case metamacro_head(__VA_ARGS__): \
+        /* a label can't be followed directly by a declaration */ \
+        ; \
+        metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+            (/* nothing to bind */) \
+            (metamacro_foreach(ADT_match_bind_iter,, metamacro_tail(__VA_ARGS__)))
+
+/*** implementation details follow ***/
+
+/*
+ * Declares a local variable for the parameter named PARAM within an #ext_match.
+ * Later clauses jump past the declaration, which is fine in C, since the
+ * variable is only meaningful within its own clause. C++ forbids that jump,
+ * hence the restriction documented on #ext_with.
+ */
+#define ADT_match_bind_iter(INDEX, PARAM) \
+    __attribute__((unused)) __typeof__(ext_matchValue_.PARAM) PARAM = ext_matchValue_.PARAM;
+
+/*
+ * Generates everything for ADT() and its variants. TAG_TYPE is the underlying
+ * type specification (if any) for the enum used as the tag. PAYLOAD_PREFIX is
+ * prepended to each constructor() to generate the structures for their
+ * parameters, and ATTRIBUTES are applied to the structure for the ADT itself.
+ */
+#define ADT_define_(NAME, TAG_TYPE, PAYLOAD_PREFIX, ATTRIBUTES, ...) \
     /* a type (NameT) for values defined by this ADT */ \
     typedef struct ADT_CURRENT_T NAME ## T; \
     \
@@ -105,18 +335,28 @@ ColorT Color.Other (double r, double g, double b);
      * ADT_typedef_constructor() instead */ \
     metamacro_foreach_concat(ADT_typedef_,, __VA_ARGS__) \
     \
+    /* an enum listing all the constructor names for this ADT */ \
+    /* it's declared outside of the structure so that, in C++, the names aren't
+     * scoped to it */ \
+    enum ADT_CURRENT_TAG_T TAG_TYPE { \
+        metamacro_foreach_concat(ADT_enum_,, __VA_ARGS__) \
+    }; \
+    \
     struct ADT_CURRENT_T { \
-        /* an enum listing all the constructor names for this ADT */ \
         /* this will also be how we know the type of this value */ \
-        const enum { \
-            metamacro_foreach_concat(ADT_enum_,, __VA_ARGS__) \
-        } tag; \
+        const enum ADT_CURRENT_TAG_T tag; \
         \
         /* overlapping storage for all the possible constructors */ \
         /* the tag above determines which parts of this union are in use */ \
         union { \
-            metamacro_foreach_concat(ADT_payload_,, __VA_ARGS__) \
+            metamacro_foreach_concat(PAYLOAD_PREFIX,, __VA_ARGS__) \
         }; \
+    } ATTRIBUTES; \
+    \
+    /* the size and alignment of NameT, for use in constant expressions */ \
+    enum { \
+        NAME ## Size = sizeof(NAME ## T), \
+        NAME ## Alignment = __alignof__(NAME ## T) \
     }; \
     \
     /* defines the actual constructor functions for this type */ \
@@ -124,32 +364,49 @@ ColorT Color.Other (double r, double g, double b);
     \
     /* this structure is used like a simple namespace for the constructors: */ \
     /* ColorT c = Color.Red(); */ \
-    const struct { \
+    /* it's static, so that the compiler can see through each function pointer
+     * to the inline constructor function, and call (or inline) it directly */ \
+    static const struct { \
         /* as the structure definition, list the function pointers and names of the constructors */ \
         metamacro_foreach_concat(ADT_fptrs_,, __VA_ARGS__) \
-    } NAME = { \
+    } NAME __attribute__((unused)) = { \
         /* then fill them in with the actual function addresses */ \
         metamacro_foreach_concat(ADT_fptrinit_,, __VA_ARGS__) \
     }; \
     \
-    /* implements NSStringFromName(), to describe an ADT value */ \
-    static inline NSString *NSStringFrom ## NAME (NAME ## T s) { \
-        NSMutableString *str = [[NSMutableString alloc] init]; \
-        \
-        /* only values with parameters will have braces added */ \
-        BOOL addedBraces = NO; \
+    /* implements NameWriteDescription(), to describe an ADT value without allocating memory */ \
+    static inline size_t NAME ## WriteDescription (NAME ## T s, char *buffer, size_t length) { \
+        ext_adtDescriptionWriter writer = { buffer, length, 0 }; \
         \
         /* construct the description differently depending on the constructor used */ \
         switch (s.tag) { \
-            metamacro_foreach_concat(ADT_tostring_,, __VA_ARGS__) \
+            metamacro_foreach_concat(ADT_write_,, __VA_ARGS__) \
             default: \
-                return nil; \
+                ; \
         } \
         \
-        if (addedBraces) \
-            [str appendString:@" }"]; \
+        return ext_adtFinishDescription(&writer); \
+    } \
+    \
+    /* implements NSStringFromName(), to describe an ADT value */ \
+    static inline NSString *NSStringFrom ## NAME (NAME ## T s) { \
+        /* most descriptions will fit on the stack, so try that first */ \
+        char buffer[256]; \
+        size_t length = NAME ## WriteDescription(s, buffer, sizeof(buffer)); \
+        \
+        /* every constructor has a non-empty name, so this is an invalid value */ \
+        if (length == 0) \
+            return nil; \
         \
-        return str; \
+        if (length < sizeof(buffer)) \
+            return [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding]; \
+        \
+        char *bytes = (char *)malloc(length + 1); \
+        if (!bytes) \
+            return nil; \
+        \
+        NAME ## WriteDescription(s, bytes, length + 1); \
+        return [[NSString alloc] initWithBytesNoCopy:bytes length:length encoding:NSUTF8StringEncoding freeWhenDone:YES]; \
     } \
     \
     /* implements NameEqualToName(), to compare ADT values for equality */ \
@@ -165,10 +422,199 @@ ColorT Color.Other (double r, double g, double b);
         } \
         \
         return YES; \
+    } \
+    \
+    /* implements NameHash(), to hash ADT values consistently with NameEqualToName() */ \
+    static inline NSUInteger NAME ## Hash (NAME ## T s) { \
+        uint64_t hash = ext_adtHashCombine(0, (uint64_t)s.tag); \
+        \
+        /* construct the hash differently depending on the constructor used */ \
+        switch (s.tag) { \
+            metamacro_foreach_concat(ADT_hash_,, __VA_ARGS__) \
+            default: \
+                ; \
+        } \
+        \
+        return (NSUInteger)ext_adtHashFinalize(hash); \
+    } \
+    \
+    /* a collection (NameArrayT) of values, stored as a column per parameter */ \
+    typedef struct { \
+        /* the tag of each value, and its row within its constructor's columns */ \
+        uint8_t *tags; \
+        size_t *rows; \
+        size_t count; \
+        size_t capacity; \
+        \
+        /* the columns for each constructor */ \
+        metamacro_foreach_concat(ADT_columns_,, __VA_ARGS__) \
+    } NAME ## ArrayT; \
+    \
+    static inline NAME ## ArrayT *NAME ## ArrayCreate (void) { \
+        return (NAME ## ArrayT *)calloc(1, sizeof(NAME ## ArrayT)); \
+    } \
+    \
+    static inline void NAME ## ArrayDestroy (NAME ## ArrayT *array) { \
+        if (!array) \
+            return; \
+        \
+        metamacro_foreach_concat(ADT_arrayfree_,, __VA_ARGS__) \
+        free(array->tags); \
+        free(array->rows); \
+        free(array); \
+    } \
+    \
+    static inline size_t NAME ## ArrayCount (NAME ## ArrayT *array) { \
+        NSCParameterAssert(array != NULL); \
+        return array->count; \
+    } \
+    \
+    static inline BOOL NAME ## ArrayAppend (NAME ## ArrayT *array, NAME ## T value) { \
+        NSCParameterAssert(array != NULL); \
+        \
+        if (array->count == array->capacity) { \
+            size_t capacity = ext_adtArrayGrownCapacity(array->capacity); \
+            uint8_t *tags = (uint8_t *)realloc(array->tags, capacity * sizeof(*tags)); \
+            if (!tags) \
+                return NO; \
+            \
+            array->tags = tags; \
+            \
+            size_t *rows = (size_t *)realloc(array->rows, capacity * sizeof(*rows)); \
+            if (!rows) \
+                return NO; \
+            \
+            array->rows = rows; \
+            array->capacity = capacity; \
+        } \
+        \
+        size_t row; \
+        \
+        /* append the parameters to the columns for the constructor used */ \
+        switch (value.tag) { \
+            metamacro_foreach_concat(ADT_arrayappend_,, __VA_ARGS__) \
+            default: \
+                return NO; \
+        } \
+        \
+        array->tags[array->count] = (uint8_t)value.tag; \
+        array->rows[array->count] = row; \
+        ++array->count; \
+        return YES; \
+    } \
+    \
+    static inline NAME ## T NAME ## ArrayGet (NAME ## ArrayT *array, size_t index) { \
+        NSCParameterAssert(array != NULL); \
+        NSCParameterAssert(index < array->count); \
+        \
+        size_t row = array->rows[index]; \
+        \
+        /* reconstruct the value from the columns for its constructor */ \
+        switch (array->tags[index]) { \
+            metamacro_foreach_concat(ADT_arrayget_,, __VA_ARGS__) \
+            default: \
+                __builtin_unreachable(); \
+        } \
+    } \
+    \
+    static inline void NAME ## ArrayFilter (NAME ## ArrayT *array, BOOL (^keep)(NAME ## T value)) { \
+        NSCParameterAssert(array != NULL); \
+        NSCParameterAssert(keep != nil); \
+        \
+        /* values are moved toward the front of the array and their columns,
+         * preserving their order, so nothing is overwritten before it's been
+         * visited */ \
+        metamacro_foreach_concat(ADT_arrayclear_,, __VA_ARGS__) \
+        size_t count = 0; \
+        \
+        for (size_t index = 0;index < array->count;++index) { \
+            if (!keep(NAME ## ArrayGet(array, index))) \
+                continue; \
+            \
+            size_t row = array->rows[index]; \
+            size_t newRow; \
+            \
+            switch (array->tags[index]) { \
+                metamacro_foreach_concat(ADT_arraymove_,, __VA_ARGS__) \
+                default: \
+                    __builtin_unreachable(); \
+            } \
+            \
+            array->tags[count] = array->tags[index]; \
+            array->rows[count] = newRow; \
+            ++count; \
+        } \
+        \
+        array->count = count; \
+    } \
+    \
+    static inline void NAME ## ArrayRemoveAll (NAME ## ArrayT *array) { \
+        NSCParameterAssert(array != NULL); \
+        \
+        metamacro_foreach_concat(ADT_arrayclear_,, __VA_ARGS__) \
+        array->count = 0; \
+    } \
+    \
+    static inline void NAME ## ArrayCompact (NAME ## ArrayT *array) { \
+        NSCParameterAssert(array != NULL); \
+        \
+        metamacro_foreach_concat(ADT_arraycompact_,, __VA_ARGS__) \
+        array->tags = (uint8_t *)ext_adtArrayShrink(array->tags, array->count, sizeof(*array->tags)); \
+        array->rows = (size_t *)ext_adtArrayShrink(array->rows, array->count, sizeof(*array->rows)); \
+        array->capacity = array->count; \
+    } \
+    \
+    /* the layout (NameRecordT) of each value in an archive */ \
+    typedef struct __attribute__((packed)) { \
+        uint8_t tag; \
+        \
+        union { \
+            metamacro_foreach_concat(ADT_packedpayload_,, __VA_ARGS__) \
+        }; \
+    } NAME ## RecordT; \
+    \
+    static inline void NAME ## EncodeRecord_ (const void *valuePtr, void *recordPtr, NSMutableArray *objects) { \
+        const NAME ## T *value = (const NAME ## T *)valuePtr; \
+        NAME ## RecordT *record = (NAME ## RecordT *)recordPtr; \
+        \
+        /* object parameters are left as nil in the record itself */ \
+        memset(record, 0, sizeof(*record)); \
+        record->tag = (uint8_t)value->tag; \
+        \
+        switch (value->tag) { \
+            metamacro_foreach_concat(ADT_encode_,, __VA_ARGS__) \
+            default: \
+                ; \
+        } \
+    } \
+    \
+    static inline NSData *NAME ## Archive (const NAME ## T *values, size_t count) { \
+        return ext_adtArchive(ADT_DEFINITION_(NAME, __VA_ARGS__), sizeof(NAME ## RecordT), values, sizeof(NAME ## T), count, &NAME ## EncodeRecord_); \
+    } \
+    \
+    static inline const NAME ## RecordT *NAME ## ArchiveRecords (const void *bytes, size_t length, size_t *count) { \
+        return (const NAME ## RecordT *)ext_adtArchiveRecords(ADT_DEFINITION_(NAME, __VA_ARGS__), sizeof(NAME ## RecordT), bytes, length, count); \
+    } \
+    \
+    static inline NSArray *NAME ## ArchiveObjects (const void *bytes, size_t length, NSSet *classes) { \
+        return ext_adtArchiveObjects(ADT_DEFINITION_(NAME, __VA_ARGS__), sizeof(NAME ## RecordT), bytes, length, classes); \
+    } \
+    \
+    static inline NAME ## T NAME ## FromRecord (const NAME ## RecordT *record, NSArray *objects) { \
+        NSCParameterAssert(record != NULL); \
+        \
+        /* rebuild the value the same way a constructor would, so that it's
+         * zero-filled and can be compared with NameEqualToName() */ \
+        switch (record->tag) { \
+            metamacro_foreach_concat(ADT_decode_,, __VA_ARGS__) \
+            default: { \
+                /* the archive is corrupt, so fall back to the first constructor */ \
+                NAME ## T s = { .tag = (enum ADT_CURRENT_TAG_T)0 }; \
+                return s; \
+            } \
+        } \
     }
 
-/*** implementation details follow ***/
-
 /*
  * This macro simply creates an enum entry for the given constructor name.
  */
@@ -260,6 +706,22 @@ typedef struct {
         metamacro_foreach_cxt_recursive(ADT_payload_entry_iter,, CONS, __VA_ARGS__) \
     };
 
+/*
+ * Like ADT_payload_constructor(), but without padding between the parameters,
+ * for PackedADT().
+ */
+#define ADT_packedpayload_constructor(...) \
+    metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+        (/* this constructor has only a name, don't add any structures */)\
+        ( \
+            ADT_packedpayload_constructor_(__VA_ARGS__) \
+        )
+
+#define ADT_packedpayload_constructor_(CONS, ...) \
+    struct __attribute__((packed)) { \
+        metamacro_foreach_cxt_recursive(ADT_payload_entry_iter,, CONS, __VA_ARGS__) \
+    };
+
 #define ADT_payload_entry_iter(INDEX, CONS, PARAM) \
     ADT_CURRENT_CONS_UNION_T(CONS, INDEX, PARAM);
 
@@ -273,7 +735,10 @@ typedef struct {
  * matches the type, but has a name we define.
  *
  * The type definitions are later used for function parameters created by
- * ADT_prototype_iter().
+ * ADT_prototype_iter(). In C, the parameters are the unions themselves, which
+ * are transparent, so they accept the user's type. C++ doesn't support
+ * transparent unions, so a second type definition names the actual type of
+ * the parameter there, as extracted by ADT_PARAMETER_TYPE().
  */
 #define ADT_typedef_constructor(...) \
     /* our first argument will always be the constructor name, so if we only
@@ -289,8 +754,11 @@ typedef struct {
     metamacro_foreach_cxt_recursive(ADT_typedef_iter,, CONS, __VA_ARGS__)
 
 #define ADT_typedef_iter(INDEX, CONS, PARAM) \
-    typedef ADT_CURRENT_CONS_UNION_T(CONS, INDEX, PARAM) __attribute__((transparent_union)) \
-        ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX);
+    typedef ADT_CURRENT_CONS_UNION_T(CONS, INDEX, PARAM) ADT_TRANSPARENT_UNION \
+        ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX); \
+    \
+    typedef ADT_PARAMETER_TYPE(PARAM, ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX)) \
+        ADT_CURRENT_CONS_ARGUMENT_T(CONS, INDEX);
 
 /*
  * This macro generates an inline function corresponding to one of the data
@@ -340,7 +808,7 @@ typedef struct {
             metamacro_if_eq_recursive(1, INDEX)()(,) \
             \
             /* parameter type */ \
-            ADT_CURRENT_CONS_ALIAS_T(CONS, metamacro_dec(INDEX)) \
+            ADT_CURRENT_CONS_ARGUMENT_T(CONS, metamacro_dec(INDEX)) \
             \
             /* parameter name */ \
             metamacro_concat(v, metamacro_dec(INDEX)) \
@@ -364,11 +832,37 @@ typedef struct {
             /* initialize the tag when the structure is created, because it cannot change later */ \
             struct ADT_CURRENT_T s = { .tag = CONS } \
         ) \
-        (ADT_initialize_memcpy(ADT_CURRENT_CONS_PAYLOAD_T(CONS, metamacro_dec(INDEX)), s, metamacro_concat(v, metamacro_dec(INDEX)))) \
+        ( \
+            ADT_initialize_memcpy(ADT_CURRENT_CONS_PAYLOAD_T(CONS, metamacro_dec(INDEX)), s, metamacro_concat(v, metamacro_dec(INDEX))) \
+            ADT_initialize_zeropadding(CONS, metamacro_dec(INDEX), s) \
+        ) \
     ;
 
 #define ADT_initialize_memcpy(UNION_NAME, ADT, ARG) \
-    memcpy(&ADT.UNION_NAME, &ARG.UNION_NAME, sizeof(ADT.UNION_NAME));
+    _Static_assert(sizeof(ARG) == sizeof(ADT.UNION_NAME), "ADT parameters of array type are not supported in C++"); \
+    memcpy(&ADT.UNION_NAME, (const void *)&ARG, sizeof(ADT.UNION_NAME));
+
+/*
+ * Structures and arrays are copied from the caller along with whatever happens
+ * to be in their padding, so the padding is cleared afterward. Otherwise,
+ * equal values could compare unequal with ADT_PARAMETER_VALUES_EQUAL(), and
+ * hash differently.
+ *
+ * Which bytes are padding is worked out from the type encoding of the
+ * parameter the first time the constructor is called, and remembered as a mask
+ * to apply to the value.
+ */
+#define ADT_initialize_zeropadding(CONS, INDEX, ADT) \
+    if (ADT_CURRENT_PARAMETER_IS_AGGREGATE(CONS, INDEX)) { \
+        static unsigned char paddingMask[sizeof(ADT.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX))]; \
+        static dispatch_once_t paddingMaskOnce; \
+        \
+        dispatch_once(&paddingMaskOnce, ^{ \
+            ext_adtGetPaddingMask(paddingMask, sizeof(paddingMask), ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX) + ADT_PARAMETER_ENCODING_OFFSET); \
+        }); \
+        \
+        ext_adtApplyPaddingMask(&ADT.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), paddingMask, sizeof(paddingMask)); \
+    }
 
 /*
  * The macros below declare and initialize the function pointers used to
@@ -380,7 +874,7 @@ typedef struct {
  *
  * The result looks something like this (using the Color example from above):
 
-const struct {
+static const struct {
     ColorT (*Red)();
     ColorT (*Green)();
     ColorT (*Blue)();
@@ -412,47 +906,242 @@ const struct {
     .metamacro_head(__VA_ARGS__) = &metamacro_concat(metamacro_head(__VA_ARGS__), _init_),
 
 /*
- * The following macros are used to generate the code for the
- * NSStringFromName() function. They essentially do something similar to
- * an Objective-C implementation of -description.
+ * The following macros are used to generate the code for NameArrayT, and the
+ * functions that operate on it.
  *
- * As with ADT_constructor(), the first variadic argument here is always the
- * constructor name. The arguments following are the parameters (as given by the
- * user).
+ * Each constructor gets a structure within NameArrayT, named after the
+ * constructor, which holds a column for each of its parameters:
+
+typedef struct {
+    uint8_t *tags;
+    size_t *rows;
+    size_t count;
+    size_t capacity;
+
+    struct {
+        size_t count;
+        size_t capacity;
+    } Red;
+
+    // ...
+
+    struct {
+        size_t count;
+        size_t capacity;
+        Other_alias0 *v0;
+        Other_alias1 *v1;
+        Other_alias2 *v2;
+    } Other;
+} ColorArrayT;
+
+ * Since each column holds the union type generated by ADT_typedef_iter(),
+ * elements can be read using the parameter's name (e.g., "Other.v0[i].r").
  *
- * As with ADT_prototype*(), our parameter numbers need to be shifted down to
- * correspond to the values in the structure.
+ * As with ADT_constructor(), the constructor name is passed as the context
+ * for each iteration, and then again as the first argument, so that the
+ * iteration always has at least one argument. Parameter numbers therefore need
+ * to be shifted down.
  */
-#define ADT_tostring_constructor(...) \
-        /* try to match each constructor against the value's tag */ \
+#define ADT_columns_constructor(...) \
+    struct { \
+        size_t count; \
+        size_t capacity; \
+        metamacro_foreach_cxt_recursive(ADT_columns_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
+    } metamacro_head(__VA_ARGS__);
+
+#define ADT_columns_iter(INDEX, CONS, PARAM) \
+    metamacro_if_eq(0, INDEX) \
+        () \
+        (ADT_CURRENT_CONS_ALIAS_T(CONS, metamacro_dec(INDEX)) *metamacro_concat(v, metamacro_dec(INDEX));)
+
+#define ADT_arrayfree_constructor(...) \
+    metamacro_foreach_cxt_recursive(ADT_arrayfree_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__)
+
+#define ADT_arrayfree_iter(INDEX, CONS, PARAM) \
+    metamacro_if_eq(0, INDEX) \
+        () \
+        (free(array->CONS.metamacro_concat(v, metamacro_dec(INDEX)));)
+
+#define ADT_arrayappend_constructor(...) \
         case metamacro_head(__VA_ARGS__): { \
-            /* now create a description from the constructor name and any parameters */ \
-            metamacro_foreach_cxt_recursive(ADT_tostring_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
+            if (array->metamacro_head(__VA_ARGS__).count == array->metamacro_head(__VA_ARGS__).capacity) { \
+                size_t capacity = ext_adtArrayGrownCapacity(array->metamacro_head(__VA_ARGS__).capacity); \
+                metamacro_foreach_cxt_recursive(ADT_arrayresize_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
+                array->metamacro_head(__VA_ARGS__).capacity = capacity; \
+            } \
+            \
+            row = array->metamacro_head(__VA_ARGS__).count++; \
+            metamacro_foreach_cxt_recursive(ADT_arrayappend_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
             break; \
         }
 
-#define ADT_tostring_iter(INDEX, CONS, PARAM) \
-    /* dispatches to one of the case macros below, based on the INDEX */ \
+#define ADT_arrayresize_iter(INDEX, CONS, PARAM) \
+    metamacro_if_eq(0, INDEX) \
+        () \
+        ( \
+            /* columns which have already grown can stay that way if a later
+             * one fails, since the capacity isn't updated */ \
+            { \
+                void *column = realloc(array->CONS.metamacro_concat(v, metamacro_dec(INDEX)), capacity * sizeof(*array->CONS.metamacro_concat(v, metamacro_dec(INDEX)))); \
+                if (!column) \
+                    return NO; \
+                \
+                array->CONS.metamacro_concat(v, metamacro_dec(INDEX)) = (__typeof__(array->CONS.metamacro_concat(v, metamacro_dec(INDEX))))column; \
+            } \
+        )
+
+#define ADT_arrayappend_iter(INDEX, CONS, PARAM) \
+    metamacro_if_eq(0, INDEX) \
+        () \
+        (memcpy(array->CONS.metamacro_concat(v, metamacro_dec(INDEX)) + row, &value.ADT_CURRENT_CONS_PAYLOAD_T(CONS, metamacro_dec(INDEX)), sizeof(*array->CONS.metamacro_concat(v, metamacro_dec(INDEX))));)
+
+#define ADT_arrayget_constructor(...) \
+        case metamacro_head(__VA_ARGS__): \
+            /* the columns have the same types as the constructor's parameters */ \
+            return metamacro_concat(metamacro_head(__VA_ARGS__), _init_)( \
+                metamacro_foreach_cxt_recursive(ADT_arrayget_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
+            );
+
+#define ADT_arrayget_iter(INDEX, CONS, PARAM) \
     metamacro_if_eq(0, INDEX) \
-        (ADT_tostring_case0(CONS, PARAM)) \
-        (metamacro_if_eq_recursive(1, INDEX) \
-            (ADT_tostring_case1(CONS, PARAM)) \
-            (ADT_tostring_defaultcase(INDEX, CONS, PARAM)) \
+        () \
+        ( \
+            /* insert a comma for every argument after index 1 */ \
+            metamacro_if_eq_recursive(1, INDEX)()(,) \
+            *(ADT_CURRENT_CONS_ARGUMENT_T(CONS, metamacro_dec(INDEX)) *)&array->CONS.metamacro_concat(v, metamacro_dec(INDEX))[row] \
         )
 
-#define ADT_tostring_case0(CONS, PARAM) \
-    /* this is the first (and possibly) only part of the description: the name
-     * of the data constructor */ \
-    [str appendString:@ # CONS];
+#define ADT_arraymove_constructor(...) \
+                case metamacro_head(__VA_ARGS__): \
+                    newRow = array->metamacro_head(__VA_ARGS__).count++; \
+                    \
+                    if (newRow != row) { \
+                        metamacro_foreach_cxt_recursive(ADT_arraymove_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
+                    } \
+                    \
+                    break;
+
+#define ADT_arraymove_iter(INDEX, CONS, PARAM) \
+    metamacro_if_eq(0, INDEX) \
+        () \
+        (memcpy(array->CONS.metamacro_concat(v, metamacro_dec(INDEX)) + newRow, array->CONS.metamacro_concat(v, metamacro_dec(INDEX)) + row, sizeof(*array->CONS.metamacro_concat(v, metamacro_dec(INDEX))));)
 
-#define ADT_tostring_case1(CONS, PARAM) \
-    /* we know now that we have arguments, so we insert a brace (and flip the
-     * corresponding flag), then begin by describing the first argument */ \
-    [str appendFormat:@" { %@", ADT_CURRENT_PARAMETER_DESCRIPTION(CONS, PARAM, s, 0)]; \
-    addedBraces = YES;
+#define ADT_arrayclear_constructor(...) \
+    array->metamacro_head(__VA_ARGS__).count = 0;
 
-#define ADT_tostring_defaultcase(INDEX, CONS, PARAM) \
-    [str appendFormat: @", %@", ADT_CURRENT_PARAMETER_DESCRIPTION(CONS, PARAM, s, metamacro_dec(INDEX))];
+#define ADT_arraycompact_constructor(...) \
+    metamacro_foreach_cxt_recursive(ADT_arraycompact_iter,, metamacro_head(__VA_ARGS__), __VA_ARGS__) \
+    array->metamacro_head(__VA_ARGS__).capacity = array->metamacro_head(__VA_ARGS__).count;
+
+#define ADT_arraycompact_iter(INDEX, CONS, PARAM) \
+    metamacro_if_eq(0, INDEX) \
+        () \
+        (array->CONS.metamacro_concat(v, metamacro_dec(INDEX)) = (__typeof__(array->CONS.metamacro_concat(v, metamacro_dec(INDEX))))ext_adtArrayShrink(array->CONS.metamacro_concat(v, metamacro_dec(INDEX)), array->CONS.count, sizeof(*array->CONS.metamacro_concat(v, metamacro_dec(INDEX))));)
+
+/*
+ * The following macros are used to generate the code for archiving values.
+ *
+ * Each NameRecordT is laid out the same way as a PackedADT() value, so scalar
+ * parameters can be read directly from an archive by name, without decoding.
+ * Object parameters are collected (in order, with NSNull in place of nil) by
+ * ADT_encode_iter(), to be stored in a keyed archive after the records, and
+ * put back by ADT_decode_iter().
+ *
+ * As with ADT_equalto*(), the first variadic argument here is the constructor
+ * name, and parameter numbers start from zero.
+ */
+#define ADT_encode_constructor(...) \
+            case metamacro_head(__VA_ARGS__): { \
+                metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+                    () \
+                    (metamacro_foreach_cxt_recursive(ADT_encode_iter,, __VA_ARGS__)) \
+                \
+                break; \
+            }
+
+#define ADT_encode_iter(INDEX, CONS, PARAM) \
+    if (ADT_CURRENT_PARAMETER_IS_OBJECT(CONS, INDEX)) { \
+        __unsafe_unretained id obj; \
+        ext_adtLoadObject(&obj, &value->ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX)); \
+        [objects addObject:(obj ?: [NSNull null])]; \
+    } else { \
+        memcpy(&record->ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), &value->ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), sizeof(record->ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX))); \
+    }
+
+#define ADT_decode_constructor(...) \
+            case metamacro_head(__VA_ARGS__): { \
+                struct ADT_CURRENT_T s = { .tag = metamacro_head(__VA_ARGS__) }; \
+                __attribute__((unused)) NSUInteger objectIndex = 0; \
+                \
+                metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+                    () \
+                    (metamacro_foreach_cxt_recursive(ADT_decode_iter,, __VA_ARGS__)) \
+                \
+                return s; \
+            }
+
+#define ADT_decode_iter(INDEX, CONS, PARAM) \
+    if (ADT_CURRENT_PARAMETER_IS_OBJECT(CONS, INDEX)) { \
+        __unsafe_unretained id obj = (objectIndex < objects.count ? [objects objectAtIndex:objectIndex] : nil); \
+        ++objectIndex; \
+        \
+        if (obj == [NSNull null]) \
+            obj = nil; \
+        \
+        memcpy(&s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), (const void *)&obj, sizeof(obj)); \
+    } else { \
+        memcpy(&s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), &record->ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), sizeof(s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX))); \
+    }
+
+/*
+ * Expands to a string literal describing the definition of the ADT, which is
+ * used to detect archives created with a different definition.
+ */
+#define ADT_DEFINITION_(NAME, ...) \
+    # NAME ": " # __VA_ARGS__
+
+/*
+ * The following macros are used to generate the code for the
+ * NameWriteDescription() function, which NSStringFromName() is built upon.
+ * They essentially do something similar to an Objective-C implementation of
+ * -description, but write directly into a caller-provided buffer.
+ *
+ * The name of each parameter is found within the stringified declaration given
+ * by the user, so no parsing happens at runtime beyond a short backward scan,
+ * and the value is formatted according to its type encoding (which is
+ * a constant string).
+ *
+ * As with ADT_equalto*(), the first variadic argument here is the constructor
+ * name, and parameter numbers start from zero.
+ */
+#define ADT_write_constructor(...) \
+        /* try to match each constructor against the value's tag */ \
+        case metamacro_head(__VA_ARGS__): { \
+            /* this is the first (and possibly only) part of the description:
+             * the name of the data constructor */ \
+            ADT_WRITE_LITERAL(metamacro_stringify(metamacro_head(__VA_ARGS__))); \
+            \
+            metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+                (/* no parameters, so no braces either */) \
+                ( \
+                    metamacro_foreach_cxt_recursive(ADT_write_iter,, __VA_ARGS__) \
+                    ADT_WRITE_LITERAL(" }"); \
+                ) \
+            \
+            break; \
+        }
+
+#define ADT_write_iter(INDEX, CONS, PARAM) \
+    /* the first parameter opens a brace, and the rest are separated by commas */ \
+    ext_adtWriteString(&writer, (INDEX == 0 ? " { " : ", "), (INDEX == 0 ? 3 : 2)); \
+    ext_adtWriteParameterName(&writer, # PARAM, sizeof(# PARAM) - 1); \
+    ext_adtWriteTypedBytes(&writer, \
+        &s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), \
+        sizeof(s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX)), \
+        ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX) + ADT_PARAMETER_ENCODING_OFFSET);
+
+#define ADT_WRITE_LITERAL(STRING) \
+    ext_adtWriteString(&writer, STRING, sizeof(STRING) - 1)
 
 /*
  * The following macros are used to generate the code for the
@@ -469,37 +1158,159 @@ const struct {
 #define ADT_equalto_constructor(...) \
         /* try to match each constructor against the value's tag */ \
         case metamacro_head(__VA_ARGS__): { \
-            metamacro_if_eq(1, metamacro_argcount(...)) \
+            metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
                 (/* no parameters, so we're equal merely if the tags are the same */) \
                 (metamacro_foreach_cxt_recursive(ADT_equalto_iter,, __VA_ARGS__)) \
             \
             break; \
         }
 
+/*
+ * The comparison used for each parameter is chosen at compile-time, so that
+ * comparing scalars compiles down to a single instruction, instead of
+ * inspecting type encodings at runtime.
+ */
 #define ADT_equalto_iter(INDEX, CONS, PARAM) \
-    { \
-        const char *paramEncoding = ext_trimADTJunkFromTypeEncoding(@encode(ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX)); \
-        \
+    if (ADT_CURRENT_PARAMETER_IS_OBJECT(CONS, INDEX)) { \
         /* use isEqual: for objects (including class objects) */ \
-        if (*paramEncoding == *@encode(id) || *paramEncoding == *@encode(Class)) { \
-            id aObj = *(__unsafe_unretained id *)&a.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX); \
-            id bObj = *(__unsafe_unretained id *)&b.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX); \
+        __unsafe_unretained id aObj, bObj; \
+        ext_adtLoadObject(&aObj, &a.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX)); \
+        ext_adtLoadObject(&bObj, &b.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX)); \
+        \
+        if (aObj != bObj && ![aObj isEqual:bObj]) \
+            return NO; \
+    } else if (!ADT_PARAMETER_VALUES_EQUAL(PARAM, &a.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), &b.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX))) { \
+        return NO; \
+    }
+
+/*
+ * The following macros are used to generate the code for the NameHash()
+ * function. Each parameter is hashed in the same way that ADT_equalto_iter()
+ * compares it, so that equal values always have equal hashes.
+ *
+ * As with ADT_equalto*(), the first variadic argument here is the constructor
+ * name, and parameter numbers start from zero.
+ */
+#define ADT_hash_constructor(...) \
+        case metamacro_head(__VA_ARGS__): { \
+            metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+                (/* no parameters, so the tag is the only thing to hash */) \
+                (metamacro_foreach_cxt_recursive(ADT_hash_iter,, __VA_ARGS__)) \
             \
-            if (!aObj) { \
-                if (bObj) { \
-                    return NO; \
-                } \
-            } else if (![aObj isEqual:bObj]) { \
-                return NO; \
-            } \
-        } else { \
-            /* prefer == to memcmp() here, since ADT values may have garbage padding
-             * bits that would cause false negatives with the latter */ \
-            if (a.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX) != b.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX)) \
-                return NO; \
-        } \
+            break; \
+        }
+
+#define ADT_hash_iter(INDEX, CONS, PARAM) \
+    if (ADT_CURRENT_PARAMETER_IS_OBJECT(CONS, INDEX)) { \
+        /* use -hash for objects, since they're compared with isEqual: */ \
+        __unsafe_unretained id obj; \
+        ext_adtLoadObject(&obj, &s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX)); \
+        hash = ext_adtHashCombine(hash, (uint64_t)[obj hash]); \
+    } else { \
+        hash = ext_adtHashCombine(hash, ADT_PARAMETER_VALUE_HASH(PARAM, &s.ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX))); \
     }
 
+/*
+ * Hashes the non-object value of type PARAM at pointer A, consistently with
+ * ADT_PARAMETER_VALUES_EQUAL().
+ *
+ * Floating-point values are widened to double (which preserves equality) and
+ * hashed with ext_adtHashDouble(), which treats positive and negative zero the
+ * same. Every other type is hashed bytewise.
+ */
+#define ADT_PARAMETER_VALUE_HASH(PARAM, A) \
+    __builtin_choose_expr(ADT_PARAMETER_IS_TYPE(PARAM, float), \
+        ext_adtHashDouble(ext_adtLoadFloat(A)), \
+    __builtin_choose_expr(ADT_PARAMETER_IS_TYPE(PARAM, double), \
+        ext_adtHashDouble(ext_adtLoadDouble(A)), \
+    __builtin_choose_expr(ADT_PARAMETER_IS_TYPE(PARAM, long double), \
+        ext_adtHashDouble((double)ext_adtLoadLongDouble(A)), \
+        ext_adtHashBytes((A), sizeof(*(A))))))
+
+/*
+ * Compares the non-object values of type PARAM at pointers A and B.
+ *
+ * Floating-point values are compared with ==, so that (for example) positive
+ * and negative zero are considered equal. Every other type is compared
+ * bytewise, which is equivalent to == for integers and pointers, and compiles
+ * to the same code when the size is constant. Structures and unions (including
+ * other ADT values) are also compared bytewise, which works for values created
+ * with ADT constructors, because those are always zero-filled, and the padding
+ * of structure parameters is cleared by ADT_initialize_zeropadding(). Padding
+ * inside unions and around bitfields can't be identified, so it is left alone.
+ */
+#define ADT_PARAMETER_VALUES_EQUAL(PARAM, A, B) \
+    __builtin_choose_expr(ADT_PARAMETER_IS_TYPE(PARAM, float), \
+        ext_adtLoadFloat(A) == ext_adtLoadFloat(B), \
+    __builtin_choose_expr(ADT_PARAMETER_IS_TYPE(PARAM, double), \
+        ext_adtLoadDouble(A) == ext_adtLoadDouble(B), \
+    __builtin_choose_expr(ADT_PARAMETER_IS_TYPE(PARAM, long double), \
+        ext_adtLoadLongDouble(A) == ext_adtLoadLongDouble(B), \
+        memcmp((A), (B), sizeof(*(A))) == 0)))
+
+/*
+ * Evaluates to a compile-time constant indicating whether the parameter
+ * declaration PARAM declares a value of type TYPE (ignoring qualifiers).
+ *
+ * Since there's no way to separate the type in a declaration from the name, we
+ * use it to declare the parameter of a function type instead, and compare that
+ * against a function type with TYPE as its parameter.
+ */
+#if defined(__cplusplus)
+    #define ADT_PARAMETER_IS_TYPE(PARAM, TYPE) \
+        __is_same(void (*)(PARAM), void (*)(TYPE))
+#else
+    #define ADT_PARAMETER_IS_TYPE(PARAM, TYPE) \
+        __builtin_types_compatible_p(void (*)(PARAM), void (*)(TYPE))
+#endif
+
+/*
+ * Evaluates to the type of a constructor parameter declared by PARAM, whose
+ * union is named ALIAS. In C, that's the union itself, which is transparent.
+ *
+ * In C++, the type is extracted from the declaration the same way as in
+ * ADT_PARAMETER_IS_TYPE(), by matching a function type against
+ * ext_adtParameterType. Function parameters of array type are adjusted to
+ * pointers, so ADTs with array parameters can only be used from C.
+ */
+#if defined(__cplusplus)
+    #define ADT_TRANSPARENT_UNION
+
+    #define ADT_PARAMETER_TYPE(PARAM, ALIAS) \
+        ext_adtParameterType<void (PARAM)>::type
+#else
+    #define ADT_TRANSPARENT_UNION __attribute__((transparent_union))
+
+    #define ADT_PARAMETER_TYPE(PARAM, ALIAS) \
+        ALIAS
+#endif
+
+/*
+ * Evaluates to whether parameter INDEX of constructor CONS is an object or
+ * class. The type encoding for the parameter's alias is a string literal, and
+ * always begins with the two unions described in ADT_payload_constructor(), so
+ * this is folded to a constant by the compiler.
+ */
+#define ADT_CURRENT_PARAMETER_IS_OBJECT(CONS, INDEX) \
+    (ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX)[ADT_PARAMETER_ENCODING_OFFSET] == *@encode(id) || \
+        ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX)[ADT_PARAMETER_ENCODING_OFFSET] == *@encode(Class))
+
+#define ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX) \
+    @encode(ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX))
+
+/*
+ * Evaluates to whether parameter INDEX of constructor CONS is a structure or
+ * array, which may contain padding. Like ADT_CURRENT_PARAMETER_IS_OBJECT(),
+ * this is folded to a constant by the compiler.
+ */
+#define ADT_CURRENT_PARAMETER_IS_AGGREGATE(CONS, INDEX) \
+    (ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX)[ADT_PARAMETER_ENCODING_OFFSET] == '{' || \
+        ADT_CURRENT_PARAMETER_ENCODING(CONS, INDEX)[ADT_PARAMETER_ENCODING_OFFSET] == '[')
+
+// the length of the "(?=(?=" prefix on the type encoding of each parameter
+// alias
+#define ADT_PARAMETER_ENCODING_OFFSET 6
+
 /*
  * The structure tag for the ADT currently being defined. This takes advantage
  * of the fact that the main ADT() is considered to exist on one line, even if
@@ -511,6 +1322,10 @@ const struct {
 #define ADT_CURRENT_T \
     metamacro_concat(_ADT_, __LINE__)
 
+// the enum tag for the constructors of the ADT currently being defined
+#define ADT_CURRENT_TAG_T \
+    metamacro_concat(ADT_CURRENT_T, _tag)
+
 /*
  * This generates an alias name that can be used to refer to the type of
  * parameter INDEX of constructor CONS (as a transparent union).
@@ -525,6 +1340,13 @@ const struct {
 #define ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX) \
     metamacro_concat(metamacro_concat(ADT_CURRENT_T, _), metamacro_concat(CONS ## _alias, INDEX))
 
+/*
+ * The type of parameter INDEX of constructor CONS, as it's passed to the
+ * constructor. See ADT_PARAMETER_TYPE().
+ */
+#define ADT_CURRENT_CONS_ARGUMENT_T(CONS, INDEX) \
+    metamacro_concat(metamacro_concat(ADT_CURRENT_T, _), metamacro_concat(CONS ## _argument, INDEX))
+
 /**
  * Creates an anonymous union that contains the user's parameter declaration as
  * a member, as well as an (other) internal union that is used to access the
@@ -548,21 +1370,204 @@ const struct {
     metamacro_concat(CONS ## _payload_, INDEX)
 
 /*
- * Expands to an NSString with a human-readable description of the current value
- * at INDEX, for constructor CONS, in the internal value structure of ADT. PARAM
- * is the parameter declaration originally given by the user.
- */
-#define ADT_CURRENT_PARAMETER_DESCRIPTION(CONS, PARAM, ADT, INDEX) \
-    [NSString stringWithFormat:@"%@ = %@", \
-        /* this is the only place where we actually parse a parameter declaration */ \
-        /* we do it here to remove the type from the description, keeping only the name */ \
-        ext_parameterNameFromDeclaration(@ # PARAM), \
-        /* convert the parameter type into an Objective-C type encoding, which,
-         * along with a pointer to the data, can be used to generate
-         * a human-readable description of the actual value */ \
-        ext_stringFromTypedBytes(&(ADT).ADT_CURRENT_CONS_PAYLOAD_T(CONS, INDEX), \
-            ext_trimADTJunkFromTypeEncoding(@encode(ADT_CURRENT_CONS_ALIAS_T(CONS, INDEX)))) \
-    ]
-
-const char *ext_trimADTJunkFromTypeEncoding (const char *encoding);
-NSString *ext_parameterNameFromDeclaration (NSString *declaration);
+ * Keeps track of the progress of NameWriteDescription(). Descriptions are
+ * truncated to fit in the buffer, but the length of the whole description is
+ * still counted, as with snprintf().
+ */
+typedef struct {
+    char *buffer;
+    size_t capacity;
+    size_t length;
+} ext_adtDescriptionWriter;
+
+#if defined(__cplusplus)
+/*
+ * Extracts the type T from the function type void (T). See
+ * ADT_PARAMETER_TYPE().
+ */
+template <typename Function>
+struct ext_adtParameterType;
+
+template <typename T>
+struct ext_adtParameterType<void (T)> {
+    typedef T type;
+};
+
+extern "C" {
+#endif
+
+/*
+ * Appends LENGTH characters from STRING to the description.
+ */
+void ext_adtWriteString (ext_adtDescriptionWriter *writer, const char *string, size_t length);
+
+/*
+ * Appends a human-readable description of the SIZE bytes at BYTES, which are
+ * of the type described by ENCODING. Only object descriptions allocate memory.
+ */
+void ext_adtWriteTypedBytes (ext_adtDescriptionWriter *writer, const void *bytes, size_t size, const char *encoding);
+
+/*
+ * Null-terminates the description (if there's room for anything at all), and
+ * returns its untruncated length.
+ */
+size_t ext_adtFinishDescription (ext_adtDescriptionWriter *writer);
+
+/*
+ * Fills MASK, which is SIZE bytes long, with 0xFF for each byte of a value of
+ * the type at ENCODING that holds data, and zero for each byte of padding.
+ * Bytes which can't be identified as padding (such as within unions) are
+ * treated as data.
+ */
+void ext_adtGetPaddingMask (unsigned char *mask, size_t size, const char *encoding);
+
+/*
+ * Clears the padding of the SIZE bytes at VALUE, using a MASK from
+ * ext_adtGetPaddingMask().
+ */
+static inline void ext_adtApplyPaddingMask (void *value, const unsigned char *mask, size_t size) {
+    unsigned char *bytes = (unsigned char *)value;
+
+    for (size_t i = 0;i < size;++i) {
+        bytes[i] &= mask[i];
+    }
+}
+
+/*
+ * Encodes the value at VALUE into the NameRecordT at RECORD, adding any object
+ * parameters to OBJECTS.
+ */
+typedef void (*ext_adtRecordEncoder)(const void *value, void *record, NSMutableArray *objects);
+
+/*
+ * Implements NameArchive(), for an ADT with the given DEFINITION (as
+ * stringified by ADT_DEFINITION_()) and record size. VALUES is an array of
+ * COUNT values, each of which is VALUE_SIZE bytes.
+ */
+NSData *ext_adtArchive (const char *definition, size_t recordSize, const void *values, size_t valueSize, size_t count, ext_adtRecordEncoder encoder);
+
+/*
+ * Implements NameArchiveRecords() and NameArchiveObjects(), for an ADT with the
+ * given DEFINITION and record size. CLASSES is the set of classes which
+ * archived objects may be instances of.
+ */
+const void *ext_adtArchiveRecords (const char *definition, size_t recordSize, const void *bytes, size_t length, size_t *count);
+NSArray *ext_adtArchiveObjects (const char *definition, size_t recordSize, const void *bytes, size_t length, NSSet *classes);
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*
+ * Appends the name from the parameter declaration DECLARATION (which is LENGTH
+ * characters long), followed by " = ". The name is always the identifier at
+ * the end of the declaration.
+ */
+static inline void ext_adtWriteParameterName (ext_adtDescriptionWriter *writer, const char *declaration, size_t length) {
+    size_t start = length;
+
+    while (start > 0) {
+        char c = declaration[start - 1];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$'))
+            break;
+
+        --start;
+    }
+
+    ext_adtWriteString(writer, declaration + start, length - start);
+    ext_adtWriteString(writer, " = ", 3);
+}
+
+/*
+ * The functions below read parameter values, which may be misaligned in
+ * a PackedADT(). For aligned values, each compiles to a single load.
+ */
+static inline float ext_adtLoadFloat (const void *ptr) {
+    float value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline double ext_adtLoadDouble (const void *ptr) {
+    double value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline long double ext_adtLoadLongDouble (const void *ptr) {
+    long double value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+// objects are loaded into a variable, instead of being returned, so that ARC
+// doesn't retain and autorelease them
+static inline void ext_adtLoadObject (__unsafe_unretained id *obj, const void *ptr) {
+    memcpy((void *)obj, ptr, sizeof(*obj));
+}
+
+/*
+ * The functions below manage the memory for the columns of a NameArrayT.
+ */
+static inline size_t ext_adtArrayGrownCapacity (size_t capacity) {
+    return (capacity ? capacity * 2 : 16);
+}
+
+// returns COLUMN shrunk to hold exactly COUNT elements, or COLUMN itself if it
+// couldn't be reallocated
+static inline void *ext_adtArrayShrink (void *column, size_t count, size_t elementSize) {
+    if (count == 0) {
+        free(column);
+        return NULL;
+    }
+
+    void *shrunk = realloc(column, count * elementSize);
+    return (shrunk ? shrunk : column);
+}
+
+/*
+ * The functions below implement the mixing used by NameHash(). Each value is
+ * folded into the running hash with a rotate, XOR, and multiply, and the result
+ * is finalized with the avalanche step from SplitMix64, so that every bit of
+ * every value affects every bit of the hash.
+ */
+static inline uint64_t ext_adtHashCombine (uint64_t hash, uint64_t value) {
+    return (((hash << 27) | (hash >> 37)) ^ value) * 0x9e3779b97f4a7c15ULL;
+}
+
+static inline uint64_t ext_adtHashFinalize (uint64_t hash) {
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+static inline uint64_t ext_adtHashDouble (double value) {
+    // positive and negative zero compare equal, so they need to hash equally
+    if (value == 0)
+        value = 0;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline uint64_t ext_adtHashBytes (const void *bytes, size_t length) {
+    // length is almost always a constant, so this loop should be unrolled
+    // into a few loads
+    const unsigned char *ptr = (const unsigned char *)bytes;
+    uint64_t hash = 0;
+
+    for (;length >= sizeof(uint64_t);length -= sizeof(uint64_t), ptr += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, ptr, sizeof(word));
+        hash = ext_adtHashCombine(hash, word);
+    }
+
+    if (length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, ptr, length);
+        hash = ext_adtHashCombine(hash, word);
+    }
+
+    return hash;
+}
@@ -8,29 +8,426 @@
 //
 
 #import "EXTADT.h"
+#import <stdarg.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
 
-const char *ext_trimADTJunkFromTypeEncoding (const char *encoding) {
-    // we need to skip past two unions in the type string
-    const char *next;
+void ext_adtWriteString (ext_adtDescriptionWriter *writer, const char *string, size_t length) {
+    // always leave room for the null terminator
+    if (writer->length + 1 < writer->capacity) {
+        size_t available = writer->capacity - writer->length - 1;
+        memcpy(writer->buffer + writer->length, string, (length < available ? length : available));
+    }
+
+    writer->length += length;
+}
+
+static void ext_adtWriteFormat (ext_adtDescriptionWriter *writer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void ext_adtWriteFormat (ext_adtDescriptionWriter *writer, const char *format, ...) {
+    // large enough for any number or pointer
+    char str[64];
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(str, sizeof(str), format, args);
+    va_end(args);
+
+    if (length > 0)
+        ext_adtWriteString(writer, str, (size_t)length < sizeof(str) ? (size_t)length : sizeof(str) - 1);
+}
+
+/*
+ * Writes the shortest representation of VALUE which reads back as the same
+ * value (as a float, if IS_FLOAT is true), which matches how NSNumber describes
+ * floating-point values.
+ */
+static void ext_adtWriteFloatingPoint (ext_adtDescriptionWriter *writer, double value, BOOL isFloat) {
+    char str[64];
 
-    for (int i = 0; i < 2; ++i) {
-        next = strstr(encoding, "(?=");
-        if (!next)
+    for (int digits = (isFloat ? 6 : 15);;++digits) {
+        snprintf(str, sizeof(str), "%.*g", digits, value);
+
+        if (digits == (isFloat ? 9 : 17))
             break;
 
-        encoding = next + 3;
+        if (isFloat ? strtof(str, NULL) == (float)value : strtod(str, NULL) == value)
+            break;
+    }
+
+    ext_adtWriteString(writer, str, strlen(str));
+}
+
+void ext_adtWriteTypedBytes (ext_adtDescriptionWriter *writer, const void *bytes, size_t size, const char *encoding) {
+    // the value may be misaligned (in a PackedADT), so copy scalars somewhere
+    // aligned before reading them
+    union {
+        long double longDoubleValue;
+        long long longLongValue;
+        void *pointerValue;
+    } aligned;
+
+    if (size <= sizeof(aligned)) {
+        memcpy(&aligned, bytes, size);
+        bytes = &aligned;
+    }
+
+    switch (*encoding) {
+        case 'c': ext_adtWriteFormat(writer, "%d", (int)*(const char *)bytes); return;
+        case 'C': ext_adtWriteFormat(writer, "%u", (unsigned)*(const unsigned char *)bytes); return;
+        case 'i': ext_adtWriteFormat(writer, "%d", *(const int *)bytes); return;
+        case 'I': ext_adtWriteFormat(writer, "%u", *(const unsigned int *)bytes); return;
+        case 's': ext_adtWriteFormat(writer, "%hd", *(const short *)bytes); return;
+        case 'S': ext_adtWriteFormat(writer, "%hu", *(const unsigned short *)bytes); return;
+        case 'l': ext_adtWriteFormat(writer, "%ld", *(const long *)bytes); return;
+        case 'L': ext_adtWriteFormat(writer, "%lu", *(const unsigned long *)bytes); return;
+        case 'q': ext_adtWriteFormat(writer, "%lld", *(const long long *)bytes); return;
+        case 'Q': ext_adtWriteFormat(writer, "%llu", *(const unsigned long long *)bytes); return;
+        case 'f': ext_adtWriteFloatingPoint(writer, *(const float *)bytes, YES); return;
+        case 'd': ext_adtWriteFloatingPoint(writer, *(const double *)bytes, NO); return;
+        case 'D': ext_adtWriteFormat(writer, "%Lg", *(const long double *)bytes); return;
+        case 'B': ext_adtWriteFormat(writer, "%d", (int)*(const _Bool *)bytes); return;
+
+        case '*': {
+            const char *str = *(const char * const *)bytes;
+            if (str) {
+                ext_adtWriteString(writer, "\"", 1);
+                ext_adtWriteString(writer, str, strlen(str));
+                ext_adtWriteString(writer, "\"", 1);
+            } else {
+                ext_adtWriteString(writer, "(null)", 6);
+            }
+
+            return;
+        }
+
+        case '@':
+        case '#': {
+            __unsafe_unretained id obj = *(__unsafe_unretained id const *)bytes;
+            if (obj) {
+                // the description is autoreleased, so this will allocate,
+                // but there's no way around that for arbitrary objects
+                const char *str = [[obj description] UTF8String];
+                ext_adtWriteString(writer, str, strlen(str));
+            } else {
+                ext_adtWriteString(writer, "(nil)", 5);
+            }
+
+            return;
+        }
+
+        case '?':
+        case '^': {
+            const void *ptr = *(const void * const *)bytes;
+            if (ptr)
+                ext_adtWriteFormat(writer, "%p", ptr);
+            else
+                ext_adtWriteString(writer, "(null)", 6);
+
+            return;
+        }
+
+        default: {
+            // dump the raw bytes, in the same format as NSValue and NSData
+            static const char hexDigits[] = "0123456789abcdef";
+            const unsigned char *ptr = bytes;
+
+            ext_adtWriteString(writer, "<", 1);
+
+            for (size_t i = 0;i < size;++i) {
+                if (i > 0 && i % 4 == 0)
+                    ext_adtWriteString(writer, " ", 1);
+
+                char hex[2] = { hexDigits[ptr[i] >> 4], hexDigits[ptr[i] & 0xf] };
+                ext_adtWriteString(writer, hex, 2);
+            }
+
+            ext_adtWriteString(writer, ">", 1);
+        }
+    }
+}
+
+size_t ext_adtFinishDescription (ext_adtDescriptionWriter *writer) {
+    if (writer->capacity > 0)
+        writer->buffer[writer->length < writer->capacity ? writer->length : writer->capacity - 1] = '\0';
+
+    return writer->length;
+}
+
+/*
+ * Marks the bytes at MASK which hold data for a value of the type at ENCODING,
+ * and returns a pointer just past that type in ENCODING.
+ */
+static const char *ext_adtMarkDataBytes (unsigned char *mask, const char *encoding) {
+    // skip type qualifiers, like const
+    while (*encoding && strchr("rnNoORV", *encoding))
+        ++encoding;
+
+    NSUInteger size = 0, alignment = 0;
+    const char *end = NSGetSizeAndAlignment(encoding, &size, &alignment);
+
+    if (*encoding == '{') {
+        const char *field = encoding + 1;
+        while (*field && *field != '=' && *field != '}')
+            ++field;
+
+        // treat the structure as all data if its fields are unknown
+        if (*field != '=') {
+            memset(mask, 0xFF, size);
+            return end;
+        }
+
+        ++field;
+
+        NSUInteger offset = 0;
+        while (*field && *field != '}') {
+            // bitfields don't fall on byte boundaries, so treat the whole
+            // structure as data
+            if (*field == 'b') {
+                memset(mask, 0xFF, size);
+                return end;
+            }
+
+            NSUInteger fieldSize = 0, fieldAlignment = 0;
+            NSGetSizeAndAlignment(field, &fieldSize, &fieldAlignment);
+
+            if (fieldAlignment > 1)
+                offset = (offset + fieldAlignment - 1) / fieldAlignment * fieldAlignment;
+
+            field = ext_adtMarkDataBytes(mask + offset, field);
+            offset += fieldSize;
+        }
+    } else if (*encoding == '[') {
+        char *element = NULL;
+        unsigned long count = strtoul(encoding + 1, &element, 10);
+
+        NSUInteger elementSize = 0, elementAlignment = 0;
+        NSGetSizeAndAlignment(element, &elementSize, &elementAlignment);
+
+        if (count > 0) {
+            ext_adtMarkDataBytes(mask, element);
+
+            for (unsigned long i = 1;i < count;++i) {
+                memcpy(mask + i * elementSize, mask, elementSize);
+            }
+        }
+    } else {
+        memset(mask, 0xFF, size);
+    }
+
+    return end;
+}
+
+void ext_adtGetPaddingMask (unsigned char *mask, size_t size, const char *encoding) {
+    NSCParameterAssert(mask != NULL);
+    NSCParameterAssert(encoding != NULL);
+
+    NSUInteger encodedSize = 0;
+    NSGetSizeAndAlignment(encoding, &encodedSize, NULL);
+
+    memset(mask, 0, size);
+
+    // if the encoding doesn't describe the value correctly, it's safer to
+    // leave the value alone
+    if (encodedSize != size) {
+        memset(mask, 0xFF, size);
+        return;
     }
 
-    return encoding;
+    ext_adtMarkDataBytes(mask, encoding);
 }
 
-NSString *ext_parameterNameFromDeclaration (NSString *declaration) {
-    NSMutableCharacterSet *identifierCharacterSet = [[NSCharacterSet alphanumericCharacterSet] mutableCopy];
-    [identifierCharacterSet addCharactersInString:@"$_"];
+/*
+ * The header at the beginning of every archive created by NameArchive(). All
+ * fields are little-endian.
+ *
+ * The header is followed by COUNT records of RECORD_SIZE bytes each, and then,
+ * if OBJECTS_LENGTH is nonzero, a keyed archive of that length containing an
+ * array of object parameters for each record.
+ */
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t definitionHash;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t objectsLength;
+} ext_adtArchiveHeader;
+
+static const char ext_adtArchiveMagic[4] = { 'E', 'X', 'T', 'A' };
+
+// the version of the archive format itself, which is independent of the
+// definitions of the ADTs being archived
+static const uint16_t ext_adtArchiveVersion = 1;
+
+// records are read in place, so the host byte order needs to match the
+// archive's
+_Static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "ADT archives require a little-endian host");
+
+// FNV-1a, which is plenty for detecting changes to a definition
+static uint32_t ext_adtDefinitionHash (const char *definition) {
+    uint32_t hash = 2166136261U;
+
+    for (const unsigned char *ptr = (const unsigned char *)definition;*ptr;++ptr) {
+        hash ^= *ptr;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+NSData *ext_adtArchive (const char *definition, size_t recordSize, const void *values, size_t valueSize, size_t count, ext_adtRecordEncoder encoder) {
+    NSCParameterAssert(definition != NULL);
+    NSCParameterAssert(recordSize <= UINT16_MAX);
+    NSCParameterAssert(values != NULL || count == 0);
+    NSCParameterAssert(encoder != NULL);
+
+    NSMutableData *data = [NSMutableData dataWithLength:sizeof(ext_adtArchiveHeader) + recordSize * count];
+    unsigned char *records = (unsigned char *)data.mutableBytes + sizeof(ext_adtArchiveHeader);
+
+    // only allocated once a record turns out to have objects
+    NSMutableArray *recordObjects = nil;
+    NSMutableArray *objects = [NSMutableArray array];
+
+    for (size_t i = 0;i < count;++i) {
+        encoder((const unsigned char *)values + i * valueSize, records + i * recordSize, objects);
+
+        if (objects.count && !recordObjects) {
+            recordObjects = [NSMutableArray arrayWithCapacity:count];
+
+            for (size_t j = 0;j < i;++j) {
+                [recordObjects addObject:@[]];
+            }
+        }
+
+        if (recordObjects) {
+            [recordObjects addObject:[objects copy]];
+            [objects removeAllObjects];
+        }
+    }
+
+    NSMutableData *objectsData = nil;
+    if (recordObjects) {
+        objectsData = [NSMutableData data];
+
+        // archives are meant to be read by other processes, so only allow
+        // objects which can be decoded securely
+        NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:objectsData];
+        archiver.requiresSecureCoding = YES;
+
+        [archiver encodeObject:recordObjects forKey:NSKeyedArchiveRootObjectKey];
+        [archiver finishEncoding];
+    }
+
+    ext_adtArchiveHeader header = {
+        .version = CFSwapInt16HostToLittle(ext_adtArchiveVersion),
+        .recordSize = CFSwapInt16HostToLittle((uint16_t)recordSize),
+        .definitionHash = CFSwapInt32HostToLittle(ext_adtDefinitionHash(definition)),
+        .count = CFSwapInt64HostToLittle(count),
+        .objectsLength = CFSwapInt64HostToLittle(objectsData.length)
+    };
+
+    memcpy(header.magic, ext_adtArchiveMagic, sizeof(header.magic));
+    memcpy(data.mutableBytes, &header, sizeof(header));
+
+    if (objectsData)
+        [data appendData:objectsData];
+
+    return data;
+}
+
+/*
+ * Validates the header of the archive at BYTES against the given definition
+ * and record size. On success, returns the number of records, and the length
+ * of the object section.
+ */
+static BOOL ext_adtReadArchiveHeader (const char *definition, size_t recordSize, const void *bytes, size_t length, size_t *count, size_t *objectsLength) {
+    if (!bytes || length < sizeof(ext_adtArchiveHeader))
+        return NO;
+
+    ext_adtArchiveHeader header;
+    memcpy(&header, bytes, sizeof(header));
+
+    if (memcmp(header.magic, ext_adtArchiveMagic, sizeof(header.magic)) != 0)
+        return NO;
+
+    if (CFSwapInt16LittleToHost(header.version) != ext_adtArchiveVersion)
+        return NO;
+
+    if (CFSwapInt16LittleToHost(header.recordSize) != recordSize)
+        return NO;
+
+    if (CFSwapInt32LittleToHost(header.definitionHash) != ext_adtDefinitionHash(definition))
+        return NO;
+
+    uint64_t recordCount = CFSwapInt64LittleToHost(header.count);
+    uint64_t objectsSize = CFSwapInt64LittleToHost(header.objectsLength);
+
+    // check the lengths without overflowing
+    size_t available = length - sizeof(ext_adtArchiveHeader);
+    if (recordSize > 0 && recordCount > available / recordSize)
+        return NO;
+
+    available -= (size_t)recordCount * recordSize;
+    if (objectsSize > available)
+        return NO;
+
+    *count = (size_t)recordCount;
+    *objectsLength = (size_t)objectsSize;
+    return YES;
+}
+
+const void *ext_adtArchiveRecords (const char *definition, size_t recordSize, const void *bytes, size_t length, size_t *count) {
+    size_t recordCount, objectsLength;
+    if (!ext_adtReadArchiveHeader(definition, recordSize, bytes, length, &recordCount, &objectsLength))
+        return NULL;
+
+    if (count)
+        *count = recordCount;
+
+    return (const unsigned char *)bytes + sizeof(ext_adtArchiveHeader);
+}
+
+NSArray *ext_adtArchiveObjects (const char *definition, size_t recordSize, const void *bytes, size_t length, NSSet *classes) {
+    NSCParameterAssert(classes != nil);
+
+    size_t recordCount, objectsLength;
+    if (!ext_adtReadArchiveHeader(definition, recordSize, bytes, length, &recordCount, &objectsLength))
+        return nil;
+
+    if (!objectsLength)
+        return nil;
+
+    const unsigned char *objectsBytes = (const unsigned char *)bytes + sizeof(ext_adtArchiveHeader) + recordCount * recordSize;
+    NSData *objectsData = [NSData dataWithBytesNoCopy:(void *)objectsBytes length:objectsLength freeWhenDone:NO];
+
+    NSArray *recordObjects = nil;
+
+    // the archive may have come from another process, so never instantiate a
+    // class which wasn't explicitly allowed
+    NSMutableSet *allowedClasses = [NSMutableSet setWithObjects:[NSArray class], [NSNull class], nil];
+    [allowedClasses unionSet:classes];
+
+    @try {
+        NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingWithData:objectsData];
+        unarchiver.requiresSecureCoding = YES;
+
+        recordObjects = [unarchiver decodeObjectOfClasses:allowedClasses forKey:NSKeyedArchiveRootObjectKey];
+        [unarchiver finishDecoding];
+    } @catch (NSException *ex) {
+        // the archive is corrupt, or contains a class which isn't allowed
+        return nil;
+    }
+
+    if (![recordObjects isKindOfClass:[NSArray class]] || recordObjects.count != recordCount)
+        return nil;
+
+    for (id objects in recordObjects) {
+        if (![objects isKindOfClass:[NSArray class]])
+            return nil;
+    }
 
-    // now invert, to get all characters disallowed in identifiers
-    [identifierCharacterSet invert];
-    
-    NSRange lastWhitespace = [declaration rangeOfCharacterFromSet:identifierCharacterSet options:NSBackwardsSearch];
-    return [declaration substringFromIndex:lastWhitespace.location + 1];
+    return recordObjects;
 }
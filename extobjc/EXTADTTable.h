@@ -0,0 +1,313 @@
+//
+//  EXTADTTable.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+#import <stdlib.h>
+#import <string.h>
+#import "EXTADT.h"
+
+/**
+ * Creates a hash map from values of the ADT named \a KEY (as defined with
+ * #ADT) to values of type \a VALUE_TYPE. The map uses open addressing with
+ * linear probing, and stores keys and values inline in a single array, so
+ * lookups never allocate memory or box the keys into objects. Keys are hashed
+ * with the KeyHash() function and compared with KeyEqualToKey().
+ *
+ * This macro will create:
+ *
+ *  - A structure type NameT, where "Name" is the first argument to this macro.
+ *  - A function NameCreate(), which allocates an empty map with room for at
+ *  least the given number of entries before it needs to grow (or a reasonable
+ *  default, if zero). Returns \c NULL if memory could not be allocated.
+ *  - A function NameDestroy(), which frees a map.
+ *  - A function NameCount(), which returns the number of entries in a map.
+ *  - A function NameSet(), which associates a value with a key, replacing any
+ *  existing value. Returns \c NO if memory could not be allocated.
+ *  - A function NameGet(), which returns a pointer to the value associated with
+ *  a key (which can be used to modify it in place), or \c NULL if there is no
+ *  such value. The pointer is invalidated by any change to the map.
+ *  - A function NameRemove(), which removes the entry for a key, and returns
+ *  whether there was one.
+ *  - A function NameEnumerate(), which invokes a block with each key and
+ *  a pointer to its value, in no particular order. The map must not be changed
+ *  during enumeration.
+ *
+ * @code
+
+ADT(Color,
+    constructor(Red),
+    constructor(Gray, double alpha)
+);
+
+ADTMap(ColorCounts, Color, NSUInteger);
+
+ColorCountsT *counts = ColorCountsCreate(0);
+ColorCountsSet(counts, Color.Gray(0.5), 1);
+
+NSUInteger *count = ColorCountsGet(counts, Color.Gray(0.5));
+if (count)
+    ++*count;
+
+ColorCountsDestroy(counts);
+
+ * @endcode
+ *
+ * @warning Keys and values are copied into the map bitwise, so any objects
+ * they contain are not retained by it. \a VALUE_TYPE must be a type that can be
+ * stored in a C structure (so an object type needs to be \c
+ * __unsafe_unretained under ARC).
+ */
+#define ADTMap(NAME, KEY, VALUE_TYPE) \
+    ADT_table_(NAME, KEY, VALUE_TYPE value;) \
+    \
+    static inline BOOL NAME ## Set (NAME ## T *table, KEY ## T key, VALUE_TYPE value) { \
+        BOOL inserted; \
+        NAME ## Entry_ *entry = NAME ## Insert_(table, key, &inserted); \
+        if (!entry) \
+            return NO; \
+        \
+        entry->value = value; \
+        return YES; \
+    } \
+    \
+    static inline VALUE_TYPE *NAME ## Get (NAME ## T *table, KEY ## T key) { \
+        NAME ## Entry_ *entry = NAME ## Find_(table, key); \
+        return (entry ? &entry->value : NULL); \
+    } \
+    \
+    static inline void NAME ## Enumerate (NAME ## T *table, void (^block)(KEY ## T key, VALUE_TYPE *value, BOOL *stop)) { \
+        NSCParameterAssert(table != NULL); \
+        NSCParameterAssert(block != nil); \
+        \
+        BOOL stop = NO; \
+        for (size_t i = 0;i < table->capacity && !stop;++i) { \
+            if (table->entries[i].hash) \
+                block(table->entries[i].key, &table->entries[i].value, &stop); \
+        } \
+    }
+
+/**
+ * Creates a hash set of values of the ADT named \a KEY (as defined with #ADT).
+ * This is implemented in the same way as #ADTMap, but without storage for
+ * values.
+ *
+ * This macro will create:
+ *
+ *  - A structure type NameT, where "Name" is the first argument to this macro.
+ *  - Functions NameCreate(), NameDestroy(), and NameCount(), which behave like
+ *  those created by #ADTMap.
+ *  - A function NameAdd(), which adds a value to a set, and returns whether it
+ *  was added (i.e., whether it was not already present). Returns \c NO if
+ *  memory could not be allocated.
+ *  - A function NameContains(), which returns whether a set contains a value.
+ *  - A function NameRemove(), which removes a value from a set, and returns
+ *  whether it was present.
+ *  - A function NameEnumerate(), which invokes a block with each value in a set,
+ *  in no particular order. The set must not be changed during enumeration.
+ *
+ * @warning Values are copied into the set bitwise, so any objects they contain
+ * are not retained by it.
+ */
+#define ADTSet(NAME, KEY) \
+    ADT_table_(NAME, KEY,) \
+    \
+    static inline BOOL NAME ## Add (NAME ## T *table, KEY ## T key) { \
+        BOOL inserted; \
+        return NAME ## Insert_(table, key, &inserted) != NULL && inserted; \
+    } \
+    \
+    static inline BOOL NAME ## Contains (NAME ## T *table, KEY ## T key) { \
+        return NAME ## Find_(table, key) != NULL; \
+    } \
+    \
+    static inline void NAME ## Enumerate (NAME ## T *table, void (^block)(KEY ## T key, BOOL *stop)) { \
+        NSCParameterAssert(table != NULL); \
+        NSCParameterAssert(block != nil); \
+        \
+        BOOL stop = NO; \
+        for (size_t i = 0;i < table->capacity && !stop;++i) { \
+            if (table->entries[i].hash) \
+                block(table->entries[i].key, &stop); \
+        } \
+    }
+
+/*** implementation details follow ***/
+
+/*
+ * Generates the parts common to ADTMap() and ADTSet(). ENTRY_MEMBERS are any
+ * additional member declarations for each entry in the table.
+ *
+ * Each entry caches the hash of its key, which avoids most calls to the
+ * equality function when probing, and makes growing the table cheap. A cached
+ * hash of zero marks an empty entry, so hashes of zero are stored as one
+ * instead.
+ *
+ * Since there are no tombstones, removal shifts later entries in the same
+ * probe sequence backward to fill the hole, keeping lookups fast regardless of
+ * how many removals have happened.
+ *
+ * Entries are always moved with memcpy(), because the tag of an ADT value is
+ * const, which makes its structure unassignable.
+ */
+#define ADT_table_(NAME, KEY, ENTRY_MEMBERS) \
+    typedef struct { \
+        NSUInteger hash; \
+        KEY ## T key; \
+        ENTRY_MEMBERS \
+    } NAME ## Entry_; \
+    \
+    typedef struct { \
+        NAME ## Entry_ *entries; \
+        \
+        /* always a power of two */ \
+        size_t capacity; \
+        size_t count; \
+    } NAME ## T; \
+    \
+    static inline NAME ## T *NAME ## Create (size_t capacity) { \
+        NAME ## T *table = calloc(1, sizeof(*table)); \
+        if (!table) \
+            return NULL; \
+        \
+        table->capacity = ext_adtTableCapacityForCount(capacity); \
+        table->entries = calloc(table->capacity, sizeof(*table->entries)); \
+        if (!table->entries) { \
+            free(table); \
+            return NULL; \
+        } \
+        \
+        return table; \
+    } \
+    \
+    static inline void NAME ## Destroy (NAME ## T *table) { \
+        if (!table) \
+            return; \
+        \
+        free(table->entries); \
+        free(table); \
+    } \
+    \
+    static inline size_t NAME ## Count (NAME ## T *table) { \
+        NSCParameterAssert(table != NULL); \
+        return table->count; \
+    } \
+    \
+    static inline NSUInteger NAME ## Hash_ (KEY ## T key) { \
+        NSUInteger hash = KEY ## Hash(key); \
+        return (hash ? hash : 1); \
+    } \
+    \
+    static inline NAME ## Entry_ *NAME ## Find_ (NAME ## T *table, KEY ## T key) { \
+        NSCParameterAssert(table != NULL); \
+        \
+        NSUInteger hash = NAME ## Hash_(key); \
+        size_t mask = table->capacity - 1; \
+        \
+        for (size_t i = hash & mask;;i = (i + 1) & mask) { \
+            NAME ## Entry_ *entry = table->entries + i; \
+            if (!entry->hash) \
+                return NULL; \
+            \
+            if (entry->hash == hash && KEY ## EqualTo ## KEY(entry->key, key)) \
+                return entry; \
+        } \
+    } \
+    \
+    static inline BOOL NAME ## Grow_ (NAME ## T *table) { \
+        size_t capacity = table->capacity * 2; \
+        size_t mask = capacity - 1; \
+        \
+        NAME ## Entry_ *entries = calloc(capacity, sizeof(*entries)); \
+        if (!entries) \
+            return NO; \
+        \
+        for (size_t i = 0;i < table->capacity;++i) { \
+            NAME ## Entry_ *entry = table->entries + i; \
+            if (!entry->hash) \
+                continue; \
+            \
+            size_t j = entry->hash & mask; \
+            while (entries[j].hash) \
+                j = (j + 1) & mask; \
+            \
+            memcpy(entries + j, entry, sizeof(*entry)); \
+        } \
+        \
+        free(table->entries); \
+        table->entries = entries; \
+        table->capacity = capacity; \
+        return YES; \
+    } \
+    \
+    /* returns the entry for KEY, adding it (without initializing any other
+     * members) if it isn't already in the table */ \
+    static inline NAME ## Entry_ *NAME ## Insert_ (NAME ## T *table, KEY ## T key, BOOL *inserted) { \
+        NAME ## Entry_ *entry = NAME ## Find_(table, key); \
+        if (entry) { \
+            *inserted = NO; \
+            return entry; \
+        } \
+        \
+        /* keep the load factor at or below 3/4 */ \
+        if ((table->count + 1) * 4 > table->capacity * 3) { \
+            if (!NAME ## Grow_(table)) { \
+                *inserted = NO; \
+                return NULL; \
+            } \
+        } \
+        \
+        NSUInteger hash = NAME ## Hash_(key); \
+        size_t mask = table->capacity - 1; \
+        \
+        size_t i = hash & mask; \
+        while (table->entries[i].hash) \
+            i = (i + 1) & mask; \
+        \
+        entry = table->entries + i; \
+        entry->hash = hash; \
+        memcpy(&entry->key, &key, sizeof(key)); \
+        \
+        ++table->count; \
+        *inserted = YES; \
+        return entry; \
+    } \
+    \
+    static inline BOOL NAME ## Remove (NAME ## T *table, KEY ## T key) { \
+        NAME ## Entry_ *entry = NAME ## Find_(table, key); \
+        if (!entry) \
+            return NO; \
+        \
+        size_t mask = table->capacity - 1; \
+        size_t hole = (size_t)(entry - table->entries); \
+        \
+        for (size_t i = (hole + 1) & mask;table->entries[i].hash;i = (i + 1) & mask) { \
+            /* an entry can fill the hole only if the hole lies between its
+             * preferred position and its current position */ \
+            size_t preferred = table->entries[i].hash & mask; \
+            if (((i - preferred) & mask) >= ((i - hole) & mask)) { \
+                memcpy(table->entries + hole, table->entries + i, sizeof(*entry)); \
+                hole = i; \
+            } \
+        } \
+        \
+        memset(table->entries + hole, 0, sizeof(*entry)); \
+        --table->count; \
+        return YES; \
+    }
+
+/*
+ * Returns the smallest power of two (and at least eight) which can hold COUNT
+ * entries without exceeding the maximum load factor.
+ */
+static inline size_t ext_adtTableCapacityForCount (size_t count) {
+    size_t capacity = 8;
+    while (capacity * 3 < count * 4)
+        capacity *= 2;
+
+    return capacity;
+}
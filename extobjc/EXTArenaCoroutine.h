@@ -0,0 +1,169 @@
+//
+//  EXTArenaCoroutine.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+#import <string.h>
+#import "EXTCoroutine.h"
+
+/**
+ * A region of memory from which allocations are made by incrementing a
+ * pointer, and which is freed all at once.
+ */
+typedef struct ext_arena ext_arena;
+
+/**
+ * Defines a coroutine, like #coroutine, whose block and persistent state are
+ * allocated from \a ARENA instead of the heap. This makes it practical to
+ * create millions of short-lived coroutines (e.g., one per record being
+ * parsed), since creating one costs a couple of pointer increments rather than
+ * several calls to \c malloc.
+ *
+ * Instead of \c __block variables, state which needs to persist between
+ * invocations is kept in a structure of type \a STATE_TYPE, which is allocated
+ * from the arena along with the coroutine, initialized to zero, and accessed
+ * through a pointer named \a STATE. Any further arguments are parameter
+ * declarations for the coroutine, as with #coroutine, and the body of the
+ * coroutine is given as a separate argument list, using #yield as usual.
+ *
+ * If memory cannot be allocated from \a ARENA, this evaluates to \c nil.
+ *
+ * @code
+
+ext_arena *arena = ext_arenaCreate(0);
+
+for (size_t n = 0;n < lineCount;++n) {
+    const char *line = lines[n];
+
+    char (^characters)(void) = arenaCoroutine(arena, struct { size_t i; }, state, void)({
+        for (;line[state->i] != '\0';++state->i) {
+            yield line[state->i];
+        }
+
+        yield (char)'\0';
+    });
+
+    // ...
+}
+
+ext_arenaReset(arena);
+
+ * @endcode
+ *
+ * @note \a STATE_TYPE must not contain any commas, so each member of a
+ * structure needs its own declaration.
+ *
+ * @warning Coroutines allocated from an arena are only valid until the arena is
+ * reset or destroyed, regardless of whether they are still retained, so strong
+ * references to them must not outlive the arena. The
+ * coroutine should only capture plain C values (like \a STATE) from its
+ * enclosing scope: if it captures any objects or \c __block variables, it
+ * cannot be moved into the arena, and will be copied to the heap instead
+ * (though it will still be released when the arena is reset).
+ */
+#define arenaCoroutine(ARENA, STATE_TYPE, STATE, ...) \
+    ^{ \
+        ext_arena *ext_arena_ = (ARENA); \
+        \
+        struct { \
+            unsigned long line; \
+            STATE_TYPE state; \
+        } *ext_arenaFrame_ = ext_arenaAllocate(ext_arena_, sizeof(*ext_arenaFrame_), __alignof__(*ext_arenaFrame_)); \
+        \
+        if (!ext_arenaFrame_) \
+            return (id)nil; \
+        \
+        memset(ext_arenaFrame_, 0, sizeof(*ext_arenaFrame_)); \
+        __typeof__(ext_arenaFrame_->state) *STATE = &ext_arenaFrame_->state; \
+        \
+        return (__bridge id)ext_arenaCopyBlock(ext_arena_, (__bridge const void *) \
+            ^(__VA_ARGS__) arenaCoroutine_body
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Creates an arena which allocates memory from the system in chunks of \a
+ * chunkSize bytes, or a reasonable default if \a chunkSize is zero. Returns \c
+ * NULL if memory could not be allocated.
+ *
+ * The arena must be freed with #ext_arenaDestroy.
+ */
+ext_arena *ext_arenaCreate (size_t chunkSize);
+
+/**
+ * Frees \a arena, along with everything allocated from it.
+ */
+void ext_arenaDestroy (ext_arena *arena);
+
+/**
+ * Allocates \a size bytes from \a arena, aligned to \a alignment (which must be
+ * a power of two). The memory is not initialized. Returns \c NULL if memory
+ * could not be allocated.
+ *
+ * Allocations which don't fit in the current chunk move on to the next one,
+ * allocating a new chunk from the system only if all of the existing ones are
+ * in use.
+ */
+void *ext_arenaAllocate (ext_arena *arena, size_t size, size_t alignment);
+
+/**
+ * Frees everything allocated from \a arena at once, keeping its chunks around
+ * for subsequent allocations. Any blocks copied into the arena are invalidated.
+ */
+void ext_arenaReset (ext_arena *arena);
+
+/**
+ * Returns the total number of bytes that \a arena has allocated from the
+ * system.
+ */
+size_t ext_arenaCapacity (ext_arena *arena);
+
+/**
+ * Moves \a block, which should not have been copied yet, into memory allocated
+ * from \a arena, and returns the arena-allocated copy. The copy is not
+ * reference counted, and remains valid until \a arena is reset or destroyed.
+ *
+ * If \a block captures any objects or \c __block variables, it is copied to the
+ * heap with \c Block_copy() instead, and released when \a arena is reset.
+ *
+ * This is used to implement #arenaCoroutine, and should not need to be called
+ * directly.
+ */
+const void *ext_arenaCopyBlock (ext_arena *arena, const void *block);
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*** implementation details follow ***/
+typedef struct {
+    unsigned long *line;
+    unsigned long *savedLine;
+} ext_arenaCoroutineLine;
+
+static inline void ext_arenaCoroutineSaveLine (ext_arenaCoroutineLine *line) {
+    *line->savedLine = *line->line;
+}
+
+// the line number is kept in a local variable while the coroutine executes,
+// so that #yield works unchanged, and written back to the frame whenever the
+// coroutine returns
+#define arenaCoroutine_body(STATEMENT) \
+            { \
+                unsigned long ext_coroutine_line_ = ext_arenaFrame_->line; \
+                \
+                __attribute__((cleanup(ext_arenaCoroutineSaveLine), unused)) \
+                ext_arenaCoroutineLine ext_arenaLine_ = { &ext_coroutine_line_, &ext_arenaFrame_->line }; \
+                \
+                for (;; ext_coroutine_line_ = 0) \
+                    switch (ext_coroutine_line_) \
+                        default: \
+                            STATEMENT \
+            }); \
+    }()
@@ -0,0 +1,229 @@
+//
+//  EXTArenaCoroutine.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTArenaCoroutine.h"
+#import <Block.h>
+#import <stddef.h>
+#import <stdint.h>
+#import <stdlib.h>
+
+// the default size of each chunk allocated by an arena
+static const size_t ext_arenaDefaultChunkSize = 64 * 1024;
+
+/*
+ * The parts of the block ABI needed to move a block into an arena, as
+ * documented at http://clang.llvm.org/docs/Block-ABI-Apple.html.
+ */
+enum {
+    ext_blockRefCountMask = 0xffff,
+    ext_blockNeedsFree = (1 << 24),
+    ext_blockHasCopyDispose = (1 << 25),
+    ext_blockIsGlobal = (1 << 28),
+
+    // indicates that the descriptor uses a different layout, which we don't
+    // attempt to read
+    ext_blockSmallDescriptor = (1 << 22)
+};
+
+typedef struct {
+    unsigned long reserved;
+    unsigned long size;
+} ext_blockDescriptor;
+
+typedef struct {
+    void *isa;
+    int flags;
+    int reserved;
+    void (*invoke)(void *, ...);
+    ext_blockDescriptor *descriptor;
+} ext_blockLayout;
+
+extern void *_NSConcreteGlobalBlock[32];
+
+typedef struct ext_arenaChunk {
+    struct ext_arenaChunk *next;
+    size_t size;
+
+    // followed by the memory for allocations
+    _Alignas(max_align_t) unsigned char bytes[];
+} ext_arenaChunk;
+
+// a block which was copied to the heap, and needs to be released when the
+// arena is reset
+typedef struct ext_arenaHeapBlock {
+    struct ext_arenaHeapBlock *next;
+    const void *block;
+} ext_arenaHeapBlock;
+
+struct ext_arena {
+    size_t chunkSize;
+
+    // every chunk owned by the arena, in the order they were allocated
+    ext_arenaChunk *firstChunk;
+
+    // the chunk currently being allocated from, and the offset of the next
+    // allocation within it
+    ext_arenaChunk *currentChunk;
+    size_t offset;
+
+    ext_arenaHeapBlock *heapBlocks;
+};
+
+static ext_arenaChunk *ext_arenaChunkCreate (size_t size) {
+    ext_arenaChunk *chunk = malloc(sizeof(*chunk) + size);
+    if (!chunk)
+        return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    return chunk;
+}
+
+/**
+ * Attempts to allocate memory from \a chunk, starting at \a offset. Returns
+ * \c NULL if there is not enough room.
+ */
+static void *ext_arenaChunkAllocate (ext_arenaChunk *chunk, size_t *offset, size_t size, size_t alignment) {
+    uintptr_t start = (uintptr_t)chunk->bytes + *offset;
+    uintptr_t aligned = (start + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t end = (size_t)(aligned - (uintptr_t)chunk->bytes) + size;
+
+    if (end > chunk->size)
+        return NULL;
+
+    *offset = end;
+    return (void *)aligned;
+}
+
+ext_arena *ext_arenaCreate (size_t chunkSize) {
+    ext_arena *arena = calloc(1, sizeof(*arena));
+    if (!arena)
+        return NULL;
+
+    arena->chunkSize = (chunkSize ? chunkSize : ext_arenaDefaultChunkSize);
+
+    arena->firstChunk = arena->currentChunk = ext_arenaChunkCreate(arena->chunkSize);
+    if (!arena->firstChunk) {
+        free(arena);
+        return NULL;
+    }
+
+    return arena;
+}
+
+void ext_arenaDestroy (ext_arena *arena) {
+    if (!arena)
+        return;
+
+    ext_arenaReset(arena);
+
+    ext_arenaChunk *chunk = arena->firstChunk;
+    while (chunk) {
+        ext_arenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    free(arena);
+}
+
+void *ext_arenaAllocate (ext_arena *arena, size_t size, size_t alignment) {
+    NSCParameterAssert(arena != NULL);
+    NSCParameterAssert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    for (;;) {
+        void *memory = ext_arenaChunkAllocate(arena->currentChunk, &arena->offset, size, alignment);
+        if (memory)
+            return memory;
+
+        // move on to the next chunk, if there is one that's big enough
+        ext_arenaChunk *next = arena->currentChunk->next;
+        if (!next || next->size < size + alignment) {
+            size_t chunkSize = arena->chunkSize;
+            if (chunkSize < size + alignment)
+                chunkSize = size + alignment;
+
+            ext_arenaChunk *chunk = ext_arenaChunkCreate(chunkSize);
+            if (!chunk)
+                return NULL;
+
+            // insert the new chunk after the current one, so that any
+            // existing chunks after it can still be used
+            chunk->next = next;
+            arena->currentChunk->next = chunk;
+            next = chunk;
+        }
+
+        arena->currentChunk = next;
+        arena->offset = 0;
+    }
+}
+
+void ext_arenaReset (ext_arena *arena) {
+    NSCParameterAssert(arena != NULL);
+
+    // the list itself is allocated from the arena, so it can be forgotten
+    // about afterward
+    for (ext_arenaHeapBlock *heapBlock = arena->heapBlocks;heapBlock;heapBlock = heapBlock->next) {
+        Block_release(heapBlock->block);
+    }
+
+    arena->heapBlocks = NULL;
+    arena->currentChunk = arena->firstChunk;
+    arena->offset = 0;
+}
+
+size_t ext_arenaCapacity (ext_arena *arena) {
+    NSCParameterAssert(arena != NULL);
+
+    size_t capacity = 0;
+    for (ext_arenaChunk *chunk = arena->firstChunk;chunk;chunk = chunk->next) {
+        capacity += chunk->size;
+    }
+
+    return capacity;
+}
+
+const void *ext_arenaCopyBlock (ext_arena *arena, const void *block) {
+    NSCParameterAssert(arena != NULL);
+    NSCParameterAssert(block != NULL);
+
+    const ext_blockLayout *layout = block;
+
+    if (layout->flags & ext_blockIsGlobal) {
+        // global blocks live forever already
+        return block;
+    }
+
+    if (!(layout->flags & (ext_blockHasCopyDispose | ext_blockSmallDescriptor))) {
+        // the block only captures plain C data, so it can be copied bitwise,
+        // and then marked as global so that retains and releases are ignored
+        size_t size = layout->descriptor->size;
+
+        ext_blockLayout *copy = ext_arenaAllocate(arena, size, __alignof__(max_align_t));
+        if (!copy)
+            return NULL;
+
+        memcpy(copy, layout, size);
+
+        copy->isa = _NSConcreteGlobalBlock;
+        copy->flags = (copy->flags & ~(ext_blockRefCountMask | ext_blockNeedsFree)) | ext_blockIsGlobal;
+
+        return copy;
+    }
+
+    ext_arenaHeapBlock *heapBlock = ext_arenaAllocate(arena, sizeof(*heapBlock), __alignof__(*heapBlock));
+    if (!heapBlock)
+        return NULL;
+
+    heapBlock->block = Block_copy(block);
+    heapBlock->next = arena->heapBlocks;
+    arena->heapBlocks = heapBlock;
+
+    return heapBlock->block;
+}
@@ -0,0 +1,202 @@
+//
+//  EXTAsyncCoroutine.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+
+@class EXTAsyncTask;
+
+/**
+ * Returned by the body of an asynchronous coroutine to describe why it stopped
+ * executing.
+ */
+typedef NS_ENUM(NSUInteger, ext_asyncStep) {
+    /**
+     * The coroutine has run to completion.
+     */
+    ext_asyncStepFinished = 0,
+
+    /**
+     * The coroutine is waiting on an #EXTCompletion, and will be scheduled
+     * again once it completes.
+     */
+    ext_asyncStepSuspended,
+
+    /**
+     * The coroutine voluntarily gave up its worker, and should be scheduled
+     * again after any other waiting tasks.
+     */
+    ext_asyncStepYielded
+};
+
+/**
+ * The body of an asynchronous coroutine, as defined by #asyncCoroutine.
+ */
+typedef ext_asyncStep (^ext_asyncCoroutineBlock)(EXTAsyncTask *task);
+
+/**
+ * Defines an asynchronous coroutine, which can be run on an #EXTExecutor with
+ * \c -spawn:. The arguments to this macro are the body of the coroutine.
+ *
+ * Asynchronous coroutines are implemented in the same way as #coroutine, but
+ * instead of returning values to their caller, they can suspend themselves
+ * until an #EXTCompletion is completed (using #ext_await), or to let other
+ * tasks run (using #ext_asyncYield). A suspended coroutine does not occupy a
+ * thread, so tens of thousands of them can be in flight on a handful of
+ * workers.
+ *
+ * @code
+
+EXTCompletion *response = [connection sendRequest:request];
+
+[executor spawn:asyncCoroutine({
+    ext_await(response);
+    [self handleResponse:response.value];
+})];
+
+ * @endcode
+ *
+ * @note As with #coroutine, any state which needs to persist across an
+ * #ext_await or #ext_asyncYield must be stored in \c __block variables. An
+ * asynchronous coroutine may resume on a different thread than the one it was
+ * suspended on, but never runs on more than one thread at a time.
+ *
+ * @note To return early, use <tt>return ext_asyncStepFinished;</tt>.
+ */
+#define asyncCoroutine(...) \
+    ^{ \
+        __block unsigned long ext_coroutine_line_ = 0; \
+        \
+        return [^ ext_asyncStep (EXTAsyncTask *ext_asyncTask_) { \
+            switch (ext_coroutine_line_) { \
+                default: \
+                    __VA_ARGS__ \
+            } \
+            \
+            ext_coroutine_line_ = 0; \
+            return ext_asyncStepFinished; \
+        } copy]; \
+    }()
+
+/**
+ * Suspends the current asynchronous coroutine until the given #EXTCompletion
+ * has completed. If it already has, execution continues immediately.
+ */
+#define ext_await(COMPLETION) \
+    if ((ext_coroutine_line_ = __LINE__), ext_asyncSuspendUntil(ext_asyncTask_, (COMPLETION))) \
+        return ext_asyncStepSuspended; \
+    else case __LINE__: \
+        ((void)0)
+
+/**
+ * Gives up the worker running the current asynchronous coroutine, allowing
+ * other tasks to run. The coroutine resumes at the next statement once it is
+ * scheduled again.
+ */
+#define ext_asyncYield \
+    if ((ext_coroutine_line_ = __LINE__)) \
+        return ext_asyncStepYielded; \
+    else case __LINE__: \
+        ((void)0)
+
+/**
+ * A one-shot event, optionally carrying a value, which asynchronous coroutines
+ * can #ext_await. This class is thread-safe.
+ */
+@interface EXTCompletion : NSObject
+
+/**
+ * Whether #complete or #completeWithValue: has been invoked.
+ */
+@property (nonatomic, readonly, getter = isCompleted) BOOL completed;
+
+/**
+ * The value this completion was completed with, or \c nil if it has not yet
+ * completed.
+ */
+@property (nonatomic, strong, readonly) id value;
+
+/**
+ * Equivalent to invoking #completeWithValue: with \c nil.
+ */
+- (BOOL)complete;
+
+/**
+ * Completes the receiver with the given value, and schedules every coroutine
+ * waiting on it. Returns \c NO if the receiver was already completed, in which
+ * case \a value is ignored.
+ */
+- (BOOL)completeWithValue:(id)value;
+
+/**
+ * Blocks the calling thread until the receiver is completed.
+ *
+ * @warning This must not be used from within an asynchronous coroutine, since
+ * it would block a worker of its executor.
+ */
+- (void)waitUntilCompleted;
+
+@end
+
+/**
+ * A thread pool which runs asynchronous coroutines. Each worker thread has its
+ * own run queue, and idle workers steal tasks from the queues of busy ones.
+ * Tasks spawned or resumed on a worker are queued on that worker, to keep
+ * related work on the same thread.
+ */
+@interface EXTExecutor : NSObject
+
+/**
+ * Returns a shared executor with one worker per active processor.
+ */
++ (instancetype)sharedExecutor;
+
+/**
+ * Initializes an executor with \a workerCount worker threads, which must be
+ * greater than zero.
+ */
+- (id)initWithWorkerCount:(NSUInteger)workerCount;
+
+/**
+ * The number of worker threads in this executor.
+ */
+@property (nonatomic, readonly) NSUInteger workerCount;
+
+/**
+ * Schedules \a coroutine to start running on one of the receiver's workers.
+ * Returns the task created for it.
+ */
+- (EXTAsyncTask *)spawn:(ext_asyncCoroutineBlock)coroutine;
+
+@end
+
+/**
+ * An asynchronous coroutine scheduled on an #EXTExecutor.
+ */
+@interface EXTAsyncTask : NSObject
+
+/**
+ * The executor this task runs on.
+ */
+@property (nonatomic, strong, readonly) EXTExecutor *executor;
+
+/**
+ * Completed once the coroutine of this task finishes. Other coroutines can
+ * #ext_await it to wait for this task.
+ */
+@property (nonatomic, strong, readonly) EXTCompletion *completion;
+
+@end
+
+/*** implementation details follow ***/
+#if defined(__cplusplus)
+extern "C" {
+#endif
+    BOOL ext_asyncSuspendUntil (EXTAsyncTask *task, EXTCompletion *completion);
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,540 @@
+//
+//  EXTAsyncCoroutine.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTAsyncCoroutine.h"
+#import <pthread.h>
+#import <stdatomic.h>
+#import <stdbool.h>
+#import <stdio.h>
+#import <stdlib.h>
+
+// the scheduling state of an EXTAsyncTask
+typedef enum {
+    // queued on an executor, or about to be
+    ext_asyncTaskRunnable = 0,
+
+    // currently executing on a worker
+    ext_asyncTaskRunning,
+
+    // waiting on an EXTCompletion
+    ext_asyncTaskSuspended,
+
+    // the completion being awaited fired before the coroutine had finished
+    // suspending, so it should be queued again right away
+    ext_asyncTaskWakePending,
+
+    // the coroutine has finished
+    ext_asyncTaskFinished
+} ext_asyncTaskState;
+
+// a FIFO of retained EXTAsyncTasks, stored as a growable ring buffer
+//
+// the owning worker takes tasks from the head, and other workers steal from
+// the tail
+typedef struct {
+    pthread_mutex_t lock;
+    void **tasks;
+    size_t head;
+    size_t count;
+    size_t capacity;
+} ext_runQueue;
+
+// the state of an EXTExecutor which is shared with its worker threads
+//
+// this is reference counted, since workers may still be running when the
+// executor is deallocated
+typedef struct {
+    size_t workerCount;
+    ext_runQueue *queues;
+
+    // workers with nothing to do wait on this condition
+    pthread_mutex_t idleLock;
+    pthread_cond_t idleCondition;
+    atomic_long idleWorkers;
+
+    // the total number of tasks in all queues (which may briefly go negative,
+    // since tasks are counted after being queued)
+    atomic_long queuedTasks;
+
+    // used to distribute tasks queued from outside of the executor
+    atomic_size_t nextQueue;
+
+    atomic_bool stopping;
+    atomic_long referenceCount;
+} ext_executorState;
+
+// the information passed to a newly-created worker thread
+typedef struct {
+    ext_executorState *state;
+    size_t index;
+} ext_workerContext;
+
+// the executor and queue index of the current thread, if it's a worker
+static __thread ext_executorState *ext_currentExecutorState = NULL;
+static __thread size_t ext_currentWorkerIndex = 0;
+
+@interface EXTAsyncTask () {
+    ext_asyncCoroutineBlock _coroutine;
+    ext_executorState *_executorState;
+    atomic_int _state;
+}
+
+- (id)initWithCoroutine:(ext_asyncCoroutineBlock)coroutine executor:(EXTExecutor *)executor executorState:(ext_executorState *)executorState;
+
+/**
+ * Runs the coroutine until it next stops, and then reschedules the receiver as
+ * appropriate.
+ */
+- (void)run;
+
+/**
+ * Schedules the receiver to run again after being suspended.
+ */
+- (void)wake;
+
+@end
+
+@interface EXTCompletion ()
+
+/**
+ * Adds \a task to the list of tasks to be woken once the receiver completes.
+ * Returns \c NO without doing anything if the receiver has already completed.
+ */
+- (BOOL)addWaitingTask:(EXTAsyncTask *)task;
+
+@end
+
+#pragma mark Run queues
+
+static void ext_runQueueInit (ext_runQueue *queue) {
+    pthread_mutex_init(&queue->lock, NULL);
+    queue->tasks = NULL;
+    queue->head = 0;
+    queue->count = 0;
+    queue->capacity = 0;
+}
+
+static void ext_runQueueDestroy (ext_runQueue *queue) {
+    for (size_t i = 0;i < queue->count;++i) {
+        // transfer each remaining task back to ARC to release it
+        EXTAsyncTask *task __attribute__((unused)) = (__bridge_transfer EXTAsyncTask *)queue->tasks[(queue->head + i) % queue->capacity];
+    }
+
+    free(queue->tasks);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+static void ext_runQueuePush (ext_runQueue *queue, void *task) {
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->count == queue->capacity) {
+        size_t newCapacity = queue->capacity ? queue->capacity * 2 : 64;
+
+        void **newTasks = malloc(sizeof(*newTasks) * newCapacity);
+        if (!newTasks) {
+            fprintf(stderr, "ERROR: Could not allocate space for %zu queued tasks\n", newCapacity);
+            abort();
+        }
+
+        for (size_t i = 0;i < queue->count;++i) {
+            newTasks[i] = queue->tasks[(queue->head + i) % queue->capacity];
+        }
+
+        free(queue->tasks);
+        queue->tasks = newTasks;
+        queue->head = 0;
+        queue->capacity = newCapacity;
+    }
+
+    queue->tasks[(queue->head + queue->count) % queue->capacity] = task;
+    ++queue->count;
+
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static void *ext_runQueuePopHead (ext_runQueue *queue) {
+    void *task = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->count) {
+        task = queue->tasks[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        --queue->count;
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+    return task;
+}
+
+static void *ext_runQueueSteal (ext_runQueue *queue) {
+    // don't wait on a queue that's busy -- just try another one
+    if (pthread_mutex_trylock(&queue->lock) != 0)
+        return NULL;
+
+    void *task = NULL;
+    if (queue->count) {
+        --queue->count;
+        task = queue->tasks[(queue->head + queue->count) % queue->capacity];
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+    return task;
+}
+
+#pragma mark Executor state
+
+static void ext_executorStateRelease (ext_executorState *state) {
+    if (atomic_fetch_sub(&state->referenceCount, 1) != 1)
+        return;
+
+    for (size_t i = 0;i < state->workerCount;++i) {
+        ext_runQueueDestroy(&state->queues[i]);
+    }
+
+    pthread_cond_destroy(&state->idleCondition);
+    pthread_mutex_destroy(&state->idleLock);
+
+    free(state->queues);
+    free(state);
+}
+
+static void ext_executorEnqueue (ext_executorState *state, EXTAsyncTask *task) {
+    size_t index;
+    if (ext_currentExecutorState == state) {
+        // keep work on the current worker when possible
+        index = ext_currentWorkerIndex;
+    } else {
+        index = atomic_fetch_add_explicit(&state->nextQueue, 1, memory_order_relaxed) % state->workerCount;
+    }
+
+    ext_runQueuePush(&state->queues[index], (__bridge_retained void *)task);
+    atomic_fetch_add(&state->queuedTasks, 1);
+
+    // this must happen after updating queuedTasks, so that a worker going to
+    // sleep either sees the new task or gets woken up
+    if (atomic_load(&state->idleWorkers) > 0) {
+        pthread_mutex_lock(&state->idleLock);
+        pthread_cond_signal(&state->idleCondition);
+        pthread_mutex_unlock(&state->idleLock);
+    }
+}
+
+static void *ext_executorDequeue (ext_executorState *state, size_t index) {
+    void *task = ext_runQueuePopHead(&state->queues[index]);
+
+    for (size_t i = 1;!task && i < state->workerCount;++i) {
+        task = ext_runQueueSteal(&state->queues[(index + i) % state->workerCount]);
+    }
+
+    if (task)
+        atomic_fetch_sub(&state->queuedTasks, 1);
+
+    return task;
+}
+
+static void *ext_workerMain (void *context) {
+    ext_workerContext *worker = context;
+    ext_executorState *state = worker->state;
+    size_t index = worker->index;
+    free(worker);
+
+    ext_currentExecutorState = state;
+    ext_currentWorkerIndex = index;
+
+    while (!atomic_load(&state->stopping)) {
+        void *task = ext_executorDequeue(state, index);
+        if (task) {
+            @autoreleasepool {
+                [(__bridge_transfer EXTAsyncTask *)task run];
+            }
+
+            continue;
+        }
+
+        pthread_mutex_lock(&state->idleLock);
+        atomic_fetch_add(&state->idleWorkers, 1);
+
+        if (atomic_load(&state->queuedTasks) <= 0 && !atomic_load(&state->stopping))
+            pthread_cond_wait(&state->idleCondition, &state->idleLock);
+
+        atomic_fetch_sub(&state->idleWorkers, 1);
+        pthread_mutex_unlock(&state->idleLock);
+    }
+
+    ext_currentExecutorState = NULL;
+    ext_executorStateRelease(state);
+    return NULL;
+}
+
+BOOL ext_asyncSuspendUntil (EXTAsyncTask *task, EXTCompletion *completion) {
+    NSCParameterAssert(task != nil);
+    NSCParameterAssert(completion != nil);
+
+    return [completion addWaitingTask:task];
+}
+
+@implementation EXTCompletion {
+    pthread_mutex_t _lock;
+    pthread_cond_t _condition;
+    atomic_bool _completed;
+
+    // tasks to wake once completed, guarded by _lock
+    NSMutableArray *_waitingTasks;
+}
+
+- (id)init {
+    if ((self = [super init])) {
+        pthread_mutex_init(&_lock, NULL);
+        pthread_cond_init(&_condition, NULL);
+        atomic_init(&_completed, false);
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    pthread_cond_destroy(&_condition);
+    pthread_mutex_destroy(&_lock);
+}
+
+- (BOOL)isCompleted {
+    return atomic_load_explicit(&_completed, memory_order_acquire);
+}
+
+- (BOOL)complete {
+    return [self completeWithValue:nil];
+}
+
+- (BOOL)completeWithValue:(id)value {
+    pthread_mutex_lock(&_lock);
+
+    if (atomic_load_explicit(&_completed, memory_order_relaxed)) {
+        pthread_mutex_unlock(&_lock);
+        return NO;
+    }
+
+    _value = value;
+    atomic_store_explicit(&_completed, true, memory_order_release);
+
+    NSArray *waitingTasks = _waitingTasks;
+    _waitingTasks = nil;
+
+    pthread_cond_broadcast(&_condition);
+    pthread_mutex_unlock(&_lock);
+
+    for (EXTAsyncTask *task in waitingTasks) {
+        [task wake];
+    }
+
+    return YES;
+}
+
+- (BOOL)addWaitingTask:(EXTAsyncTask *)task {
+    if (self.completed)
+        return NO;
+
+    pthread_mutex_lock(&_lock);
+
+    if (atomic_load_explicit(&_completed, memory_order_relaxed)) {
+        pthread_mutex_unlock(&_lock);
+        return NO;
+    }
+
+    if (!_waitingTasks)
+        _waitingTasks = [[NSMutableArray alloc] init];
+
+    [_waitingTasks addObject:task];
+
+    pthread_mutex_unlock(&_lock);
+    return YES;
+}
+
+- (void)waitUntilCompleted {
+    if (self.completed)
+        return;
+
+    pthread_mutex_lock(&_lock);
+
+    while (!atomic_load_explicit(&_completed, memory_order_relaxed)) {
+        pthread_cond_wait(&_condition, &_lock);
+    }
+
+    pthread_mutex_unlock(&_lock);
+}
+
+@end
+
+@implementation EXTExecutor {
+    ext_executorState *_state;
+}
+
++ (instancetype)sharedExecutor {
+    static EXTExecutor *sharedExecutor = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        sharedExecutor = [[self alloc] initWithWorkerCount:[NSProcessInfo processInfo].activeProcessorCount];
+    });
+
+    return sharedExecutor;
+}
+
+- (id)init {
+    return [self initWithWorkerCount:[NSProcessInfo processInfo].activeProcessorCount];
+}
+
+- (id)initWithWorkerCount:(NSUInteger)workerCount {
+    NSParameterAssert(workerCount > 0);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    _workerCount = workerCount;
+
+    _state = calloc(1, sizeof(*_state));
+    if (!_state)
+        return nil;
+
+    _state->queues = calloc(workerCount, sizeof(*_state->queues));
+    if (!_state->queues) {
+        free(_state);
+        _state = NULL;
+        return nil;
+    }
+
+    _state->workerCount = workerCount;
+    for (size_t i = 0;i < workerCount;++i) {
+        ext_runQueueInit(&_state->queues[i]);
+    }
+
+    pthread_mutex_init(&_state->idleLock, NULL);
+    pthread_cond_init(&_state->idleCondition, NULL);
+    atomic_init(&_state->idleWorkers, 0);
+    atomic_init(&_state->queuedTasks, 0);
+    atomic_init(&_state->nextQueue, 0);
+    atomic_init(&_state->stopping, false);
+
+    // one reference for the executor, plus one for each worker
+    atomic_init(&_state->referenceCount, (long)workerCount + 1);
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+    for (size_t i = 0;i < workerCount;++i) {
+        ext_workerContext *context = malloc(sizeof(*context));
+        if (!context) {
+            fprintf(stderr, "ERROR: Could not allocate context for worker thread %zu\n", i);
+            abort();
+        }
+
+        context->state = _state;
+        context->index = i;
+
+        pthread_t thread;
+        if (pthread_create(&thread, &attributes, &ext_workerMain, context) != 0) {
+            fprintf(stderr, "ERROR: Could not create worker thread %zu\n", i);
+            abort();
+        }
+    }
+
+    pthread_attr_destroy(&attributes);
+    return self;
+}
+
+- (void)dealloc {
+    if (!_state)
+        return;
+
+    atomic_store(&_state->stopping, true);
+
+    pthread_mutex_lock(&_state->idleLock);
+    pthread_cond_broadcast(&_state->idleCondition);
+    pthread_mutex_unlock(&_state->idleLock);
+
+    ext_executorStateRelease(_state);
+}
+
+- (EXTAsyncTask *)spawn:(ext_asyncCoroutineBlock)coroutine {
+    NSParameterAssert(coroutine != nil);
+
+    EXTAsyncTask *task = [[EXTAsyncTask alloc] initWithCoroutine:coroutine executor:self executorState:_state];
+    ext_executorEnqueue(_state, task);
+
+    return task;
+}
+
+@end
+
+@implementation EXTAsyncTask
+
+- (id)initWithCoroutine:(ext_asyncCoroutineBlock)coroutine executor:(EXTExecutor *)executor executorState:(ext_executorState *)executorState {
+    if ((self = [super init])) {
+        _coroutine = [coroutine copy];
+        _executor = executor;
+        _executorState = executorState;
+        _completion = [[EXTCompletion alloc] init];
+        atomic_init(&_state, ext_asyncTaskRunnable);
+    }
+
+    return self;
+}
+
+- (void)run {
+    atomic_store(&_state, ext_asyncTaskRunning);
+
+    switch (_coroutine(self)) {
+        case ext_asyncStepFinished:
+            atomic_store(&_state, ext_asyncTaskFinished);
+
+            // release anything captured by the coroutine as soon as possible
+            _coroutine = nil;
+
+            [_completion complete];
+            break;
+
+        case ext_asyncStepYielded:
+            atomic_store(&_state, ext_asyncTaskRunnable);
+            ext_executorEnqueue(_executorState, self);
+            break;
+
+        case ext_asyncStepSuspended: {
+            int expected = ext_asyncTaskRunning;
+            if (!atomic_compare_exchange_strong(&_state, &expected, ext_asyncTaskSuspended)) {
+                // we were woken up while still running
+                atomic_store(&_state, ext_asyncTaskRunnable);
+                ext_executorEnqueue(_executorState, self);
+            }
+
+            break;
+        }
+    }
+}
+
+- (void)wake {
+    int state = atomic_load(&_state);
+
+    for (;;) {
+        if (state == ext_asyncTaskSuspended) {
+            if (atomic_compare_exchange_weak(&_state, &state, ext_asyncTaskRunnable)) {
+                ext_executorEnqueue(_executorState, self);
+                return;
+            }
+        } else if (state == ext_asyncTaskRunning) {
+            // -run will queue us again once the coroutine returns
+            if (atomic_compare_exchange_weak(&_state, &state, ext_asyncTaskWakePending))
+                return;
+        } else {
+            return;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,192 @@
+//
+//  EXTChannel.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Determines which threads may use an #ext_channel concurrently.
+ */
+typedef NS_ENUM(NSUInteger, ext_channelKind) {
+    /**
+     * Only one thread (or coroutine) at a time may send values, and only one
+     * may receive values. This is the fastest kind of channel, and is suited to
+     * the links between consecutive stages of a pipeline.
+     */
+    ext_channelSingleProducerSingleConsumer = 0,
+
+    /**
+     * Any number of threads may send and receive values concurrently. This is
+     * suited to fanning work out to, or in from, a pool of threads.
+     */
+    ext_channelMultipleProducerMultipleConsumer
+};
+
+/**
+ * Determines what the blocking channel functions do while they wait for space
+ * or values to become available.
+ */
+typedef NS_ENUM(NSUInteger, ext_channelWaitStrategy) {
+    /**
+     * After spinning briefly, put the waiting thread to sleep until another
+     * thread makes progress. This wastes no CPU time, but waking up a sleeping
+     * thread adds latency.
+     */
+    ext_channelWaitBlock = 0,
+
+    /**
+     * After spinning briefly, repeatedly yield the processor to other threads.
+     * This has lower latency than #ext_channelWaitBlock, but keeps waiting
+     * threads runnable, so it should only be used when each stage of a
+     * pipeline has a core to itself.
+     */
+    ext_channelWaitYield
+};
+
+/**
+ * The result of a non-blocking channel operation.
+ */
+typedef NS_ENUM(NSUInteger, ext_channelResult) {
+    /**
+     * The value was sent or received.
+     */
+    ext_channelSuccess = 0,
+
+    /**
+     * The channel was full (when sending) or empty (when receiving), and the
+     * operation should be retried later.
+     */
+    ext_channelWouldBlock,
+
+    /**
+     * The channel has been closed. When receiving, this is only returned once
+     * all values sent before the channel was closed have been received.
+     */
+    ext_channelClosed
+};
+
+/**
+ * A bounded, lock-free queue of fixed-size values, which can be used to stream
+ * values between threads or coroutines.
+ *
+ * Values are copied into and out of a ring buffer which is allocated when the
+ * channel is created, so sending and receiving never allocate memory. When the
+ * buffer is full, senders must wait for receivers to catch up, which keeps a
+ * fast producer from running arbitrarily far ahead of a slow consumer.
+ *
+ * @code
+
+ext_channel *lines = ext_channelCreate(ext_channelSingleProducerSingleConsumer, sizeof(NSRange), 1024, ext_channelWaitBlock);
+
+dispatch_async(parseQueue, ^{
+    for (NSRange range = ...) {
+        ext_channelSend(lines, &range);
+    }
+
+    ext_channelClose(lines);
+});
+
+NSRange range;
+while (ext_channelReceive(lines, &range)) {
+    // process the line
+}
+
+ext_channelDestroy(lines);
+
+ * @endcode
+ *
+ * The non-blocking #ext_channelTrySend and #ext_channelTryReceive can be used
+ * from coroutines, which should yield when a channel isn't ready instead of
+ * holding up their thread. For example, with #asyncCoroutine:
+ *
+ * @code
+
+[executor spawn:asyncCoroutine({
+    for (i = 0;i < count;++i) {
+        while (ext_channelTrySend(channel, &values[i]) == ext_channelWouldBlock) {
+            ext_asyncYield;
+        }
+    }
+
+    ext_channelClose(channel);
+})];
+
+ * @endcode
+ *
+ * @note Channels copy values bitwise. To send objects under ARC, send a pointer
+ * obtained with \c __bridge_retained, and convert it back with \c
+ * __bridge_transfer after receiving it. Any values still in a channel when it
+ * is destroyed are simply discarded.
+ */
+typedef struct ext_channel ext_channel;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Creates a channel of values which are each \a elementSize bytes in size. The
+ * channel will be able to hold at least \a capacity values before senders
+ * must wait; \a capacity is rounded up to a power of two.
+ *
+ * Returns \c NULL if memory could not be allocated. The channel must be freed
+ * with #ext_channelDestroy.
+ */
+ext_channel *ext_channelCreate (ext_channelKind kind, size_t elementSize, size_t capacity, ext_channelWaitStrategy waitStrategy);
+
+/**
+ * Frees \a channel. No other thread may be using \a channel at the time of the
+ * call.
+ */
+void ext_channelDestroy (ext_channel *channel);
+
+/**
+ * Copies the value at \a value into \a channel, if there's room for it.
+ */
+ext_channelResult ext_channelTrySend (ext_channel *channel, const void *value);
+
+/**
+ * Copies the oldest value in \a channel into \a value, if there is one.
+ */
+ext_channelResult ext_channelTryReceive (ext_channel *channel, void *value);
+
+/**
+ * Copies the value at \a value into \a channel, waiting for room if necessary.
+ * Returns \c NO if \a channel has been closed, in which case the value was not
+ * sent.
+ */
+BOOL ext_channelSend (ext_channel *channel, const void *value);
+
+/**
+ * Copies the oldest value in \a channel into \a value, waiting for one to be
+ * sent if necessary. Returns \c NO once \a channel has been closed and all
+ * of its values have been received.
+ */
+BOOL ext_channelReceive (ext_channel *channel, void *value);
+
+/**
+ * Closes \a channel, so that no more values can be sent, and wakes up any
+ * threads waiting on it. Values which were already sent can still be received.
+ *
+ * @note This should only be called once every producer is done sending.
+ * Values sent concurrently with this call may not be received.
+ */
+void ext_channelClose (ext_channel *channel);
+
+/**
+ * Returns whether #ext_channelClose has been called on \a channel.
+ */
+BOOL ext_channelIsClosed (ext_channel *channel);
+
+/**
+ * Returns the number of values that \a channel can hold, after rounding up.
+ */
+size_t ext_channelCapacity (ext_channel *channel);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,405 @@
+//
+//  EXTChannel.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTChannel.h"
+#import <pthread.h>
+#import <sched.h>
+#import <stdatomic.h>
+#import <stdlib.h>
+#import <string.h>
+
+// the alignment used to keep producer and consumer state from sharing a cache
+// line
+#define EXT_CHANNEL_CACHE_LINE_SIZE 64
+
+// the number of times to retry an operation before falling back to the wait
+// strategy
+static const unsigned ext_channelSpinCount = 128;
+
+struct ext_channel {
+    // written by producers
+    _Alignas(EXT_CHANNEL_CACHE_LINE_SIZE) atomic_size_t tail;
+
+    // for single-producer channels, the producer's most recent view of the
+    // head, which saves it from reading the consumer's cache line on every send
+    size_t cachedHead;
+
+    // written by consumers
+    _Alignas(EXT_CHANNEL_CACHE_LINE_SIZE) atomic_size_t head;
+
+    // for single-consumer channels, the consumer's most recent view of the tail
+    size_t cachedTail;
+
+    // the number of threads sleeping in ext_channelSend() or
+    // ext_channelReceive(), which are only touched when a channel is full or
+    // empty
+    _Alignas(EXT_CHANNEL_CACHE_LINE_SIZE) atomic_size_t sendWaiters;
+    atomic_size_t receiveWaiters;
+    atomic_bool closed;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t notFull;
+    pthread_cond_t notEmpty;
+
+    // immutable after creation
+    ext_channelKind kind;
+    ext_channelWaitStrategy waitStrategy;
+    size_t elementSize;
+    size_t mask;
+
+    // for multiple-producer multiple-consumer channels, the sequence number of
+    // each slot, which indicates whether it's ready to be written or read
+    atomic_size_t *sequences;
+
+    unsigned char *buffer;
+};
+
+static inline void ext_channelRelax (void) {
+    #if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+    #elif defined(__arm__) || defined(__arm64__) || defined(__aarch64__)
+    __asm__ __volatile__ ("yield");
+    #endif
+}
+
+static inline unsigned char *ext_channelSlot (ext_channel *channel, size_t position) {
+    return channel->buffer + (position & channel->mask) * channel->elementSize;
+}
+
+/*
+ * Single-producer single-consumer ring buffer.
+ *
+ * The head and tail increase monotonically, and are only ever written by the
+ * consumer and producer, respectively.
+ */
+static BOOL ext_channelSPSCTrySend (ext_channel *channel, const void *value) {
+    size_t tail = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+    size_t capacity = channel->mask + 1;
+
+    if (tail - channel->cachedHead == capacity) {
+        channel->cachedHead = atomic_load_explicit(&channel->head, memory_order_acquire);
+        if (tail - channel->cachedHead == capacity)
+            return NO;
+    }
+
+    memcpy(ext_channelSlot(channel, tail), value, channel->elementSize);
+    atomic_store_explicit(&channel->tail, tail + 1, memory_order_release);
+
+    return YES;
+}
+
+static BOOL ext_channelSPSCTryReceive (ext_channel *channel, void *value) {
+    size_t head = atomic_load_explicit(&channel->head, memory_order_relaxed);
+
+    if (head == channel->cachedTail) {
+        channel->cachedTail = atomic_load_explicit(&channel->tail, memory_order_acquire);
+        if (head == channel->cachedTail)
+            return NO;
+    }
+
+    memcpy(value, ext_channelSlot(channel, head), channel->elementSize);
+    atomic_store_explicit(&channel->head, head + 1, memory_order_release);
+
+    return YES;
+}
+
+/*
+ * Multiple-producer multiple-consumer ring buffer.
+ *
+ * Producers and consumers claim positions by advancing the tail and head with
+ * a CAS. Each slot's sequence number is equal to its position when it's ready
+ * to be written, and its position plus one when it's ready to be read, so
+ * claiming a slot never requires waiting on another thread.
+ */
+static BOOL ext_channelMPMCTrySend (ext_channel *channel, const void *value) {
+    size_t position = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+    atomic_size_t *sequence;
+
+    for (;;) {
+        sequence = channel->sequences + (position & channel->mask);
+
+        size_t seq = atomic_load_explicit(sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)seq - (intptr_t)position;
+
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&channel->tail, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            // the slot still holds a value from the previous lap
+            return NO;
+        } else {
+            position = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+        }
+    }
+
+    memcpy(ext_channelSlot(channel, position), value, channel->elementSize);
+    atomic_store_explicit(sequence, position + 1, memory_order_release);
+
+    return YES;
+}
+
+static BOOL ext_channelMPMCTryReceive (ext_channel *channel, void *value) {
+    size_t position = atomic_load_explicit(&channel->head, memory_order_relaxed);
+    atomic_size_t *sequence;
+
+    for (;;) {
+        sequence = channel->sequences + (position & channel->mask);
+
+        size_t seq = atomic_load_explicit(sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)seq - (intptr_t)(position + 1);
+
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&channel->head, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            // nothing has been written to the slot yet
+            return NO;
+        } else {
+            position = atomic_load_explicit(&channel->head, memory_order_relaxed);
+        }
+    }
+
+    memcpy(value, ext_channelSlot(channel, position), channel->elementSize);
+
+    // make the slot available to producers on the next lap
+    atomic_store_explicit(sequence, position + channel->mask + 1, memory_order_release);
+
+    return YES;
+}
+
+/**
+ * Attempts to send a value without waking up any waiting receivers.
+ */
+static ext_channelResult ext_channelTrySendQuietly (ext_channel *channel, void *value) {
+    if (atomic_load_explicit(&channel->closed, memory_order_relaxed))
+        return ext_channelClosed;
+
+    BOOL sent;
+    if (channel->kind == ext_channelSingleProducerSingleConsumer)
+        sent = ext_channelSPSCTrySend(channel, value);
+    else
+        sent = ext_channelMPMCTrySend(channel, value);
+
+    return (sent ? ext_channelSuccess : ext_channelWouldBlock);
+}
+
+/**
+ * Attempts to receive a value without waking up any waiting senders.
+ */
+static ext_channelResult ext_channelTryReceiveQuietly (ext_channel *channel, void *value) {
+    BOOL (*receive)(ext_channel *, void *);
+    if (channel->kind == ext_channelSingleProducerSingleConsumer)
+        receive = &ext_channelSPSCTryReceive;
+    else
+        receive = &ext_channelMPMCTryReceive;
+
+    if (receive(channel, value))
+        return ext_channelSuccess;
+
+    if (!atomic_load_explicit(&channel->closed, memory_order_acquire))
+        return ext_channelWouldBlock;
+
+    // values sent before the channel was closed are guaranteed to be visible
+    // now, so check one last time
+    return (receive(channel, value) ? ext_channelSuccess : ext_channelClosed);
+}
+
+/**
+ * Wakes up any threads sleeping on \a condition, after a successful operation
+ * which may have made progress possible for them.
+ */
+static void ext_channelNotify (ext_channel *channel, atomic_size_t *waiters, pthread_cond_t *condition) {
+    if (channel->waitStrategy != ext_channelWaitBlock)
+        return;
+
+    // pairs with the fence in ext_channelWait(), so that either the waiter
+    // sees the operation that just completed, or we see the waiter
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(waiters, memory_order_relaxed) == 0)
+        return;
+
+    pthread_mutex_lock(&channel->mutex);
+    pthread_cond_broadcast(condition);
+    pthread_mutex_unlock(&channel->mutex);
+}
+
+/**
+ * Repeatedly invokes \a operation until it returns something other than
+ * #ext_channelWouldBlock, waiting according to the channel's wait strategy in
+ * between.
+ */
+static ext_channelResult ext_channelWait (ext_channel *channel, ext_channelResult (*operation)(ext_channel *, void *), void *value, atomic_size_t *waiters, pthread_cond_t *condition) {
+    ext_channelResult result;
+
+    for (unsigned spins = 0;spins < ext_channelSpinCount;++spins) {
+        result = operation(channel, value);
+        if (result != ext_channelWouldBlock)
+            return result;
+
+        ext_channelRelax();
+    }
+
+    if (channel->waitStrategy == ext_channelWaitYield) {
+        while ((result = operation(channel, value)) == ext_channelWouldBlock) {
+            sched_yield();
+        }
+
+        return result;
+    }
+
+    pthread_mutex_lock(&channel->mutex);
+    atomic_fetch_add_explicit(waiters, 1, memory_order_relaxed);
+
+    // pairs with the fence in ext_channelNotify()
+    atomic_thread_fence(memory_order_seq_cst);
+
+    // operation must not notify anyone itself, since we're holding the mutex
+    while ((result = operation(channel, value)) == ext_channelWouldBlock) {
+        pthread_cond_wait(condition, &channel->mutex);
+    }
+
+    atomic_fetch_sub_explicit(waiters, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&channel->mutex);
+
+    return result;
+}
+
+ext_channel *ext_channelCreate (ext_channelKind kind, size_t elementSize, size_t capacity, ext_channelWaitStrategy waitStrategy) {
+    NSCParameterAssert(elementSize > 0);
+    NSCParameterAssert(capacity > 0);
+
+    // the MPMC algorithm needs at least two slots to distinguish a full slot
+    // from an empty one
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < capacity) {
+        roundedCapacity <<= 1;
+    }
+
+    void *memory = NULL;
+    if (posix_memalign(&memory, EXT_CHANNEL_CACHE_LINE_SIZE, sizeof(ext_channel)) != 0)
+        return NULL;
+
+    ext_channel *channel = memory;
+    memset(channel, 0, sizeof(*channel));
+
+    channel->kind = kind;
+    channel->waitStrategy = waitStrategy;
+    channel->elementSize = elementSize;
+    channel->mask = roundedCapacity - 1;
+
+    atomic_init(&channel->tail, 0);
+    atomic_init(&channel->head, 0);
+    atomic_init(&channel->sendWaiters, 0);
+    atomic_init(&channel->receiveWaiters, 0);
+    atomic_init(&channel->closed, false);
+
+    channel->buffer = calloc(roundedCapacity, elementSize);
+    if (!channel->buffer) {
+        free(channel);
+        return NULL;
+    }
+
+    if (kind == ext_channelMultipleProducerMultipleConsumer) {
+        channel->sequences = calloc(roundedCapacity, sizeof(*channel->sequences));
+        if (!channel->sequences) {
+            free(channel->buffer);
+            free(channel);
+            return NULL;
+        }
+
+        for (size_t i = 0;i < roundedCapacity;++i) {
+            atomic_init(channel->sequences + i, i);
+        }
+    }
+
+    pthread_mutex_init(&channel->mutex, NULL);
+    pthread_cond_init(&channel->notFull, NULL);
+    pthread_cond_init(&channel->notEmpty, NULL);
+
+    return channel;
+}
+
+void ext_channelDestroy (ext_channel *channel) {
+    if (!channel)
+        return;
+
+    pthread_cond_destroy(&channel->notEmpty);
+    pthread_cond_destroy(&channel->notFull);
+    pthread_mutex_destroy(&channel->mutex);
+
+    free(channel->sequences);
+    free(channel->buffer);
+    free(channel);
+}
+
+ext_channelResult ext_channelTrySend (ext_channel *channel, const void *value) {
+    NSCParameterAssert(channel != NULL);
+    NSCParameterAssert(value != NULL);
+
+    ext_channelResult result = ext_channelTrySendQuietly(channel, (void *)value);
+    if (result == ext_channelSuccess)
+        ext_channelNotify(channel, &channel->receiveWaiters, &channel->notEmpty);
+
+    return result;
+}
+
+ext_channelResult ext_channelTryReceive (ext_channel *channel, void *value) {
+    NSCParameterAssert(channel != NULL);
+    NSCParameterAssert(value != NULL);
+
+    ext_channelResult result = ext_channelTryReceiveQuietly(channel, value);
+    if (result == ext_channelSuccess)
+        ext_channelNotify(channel, &channel->sendWaiters, &channel->notFull);
+
+    return result;
+}
+
+BOOL ext_channelSend (ext_channel *channel, const void *value) {
+    NSCParameterAssert(channel != NULL);
+    NSCParameterAssert(value != NULL);
+
+    if (ext_channelWait(channel, &ext_channelTrySendQuietly, (void *)value, &channel->sendWaiters, &channel->notFull) != ext_channelSuccess)
+        return NO;
+
+    ext_channelNotify(channel, &channel->receiveWaiters, &channel->notEmpty);
+    return YES;
+}
+
+BOOL ext_channelReceive (ext_channel *channel, void *value) {
+    NSCParameterAssert(channel != NULL);
+    NSCParameterAssert(value != NULL);
+
+    if (ext_channelWait(channel, &ext_channelTryReceiveQuietly, value, &channel->receiveWaiters, &channel->notEmpty) != ext_channelSuccess)
+        return NO;
+
+    ext_channelNotify(channel, &channel->sendWaiters, &channel->notFull);
+    return YES;
+}
+
+void ext_channelClose (ext_channel *channel) {
+    NSCParameterAssert(channel != NULL);
+
+    atomic_store_explicit(&channel->closed, true, memory_order_release);
+
+    // wake everyone up, so that they notice the channel is closed
+    pthread_mutex_lock(&channel->mutex);
+    pthread_cond_broadcast(&channel->notFull);
+    pthread_cond_broadcast(&channel->notEmpty);
+    pthread_mutex_unlock(&channel->mutex);
+}
+
+BOOL ext_channelIsClosed (ext_channel *channel) {
+    NSCParameterAssert(channel != NULL);
+    return atomic_load_explicit(&channel->closed, memory_order_acquire);
+}
+
+size_t ext_channelCapacity (ext_channel *channel) {
+    NSCParameterAssert(channel != NULL);
+    return channel->mask + 1;
+}
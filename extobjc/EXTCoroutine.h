@@ -7,6 +7,11 @@
 //  Released under the MIT license.
 //
 
+#import <limits.h>
+#import <stddef.h>
+#import <string.h>
+#import "metamacros.h"
+
 /**
  * Defines a coroutine, which is a generalized version of a subroutine that
  * supports multiple entry and exit points. This macro takes as its arguments
@@ -47,7 +52,8 @@ double y = myCoroutine(42, 2.0);
  * contain some execution state, executing the same coroutine on multiple
  * threads is considered undefined behavior. It is, however, legal to
  * synchronize a coroutine to ensure that it only executes on a single thread at
- * any given time.
+ * any given time. To stream values between coroutines running on different
+ * threads, use an #ext_channel from EXTChannel.
  */
 #define coroutine(...) \
     ^{ \
@@ -72,6 +78,170 @@ double y = myCoroutine(42, 2.0);
     else \
         return
 
+/**
+ * Defines a batched coroutine, which produces many values of type \a TYPE each
+ * time it is invoked. The first argument to this macro is the type of values
+ * produced, and any further arguments are parameter declarations for the
+ * coroutine, as with #coroutine.
+ *
+ * The resulting block accepts a buffer of \a TYPE and the capacity of that
+ * buffer (which must be greater than zero), followed by any declared
+ * parameters. Each invocation of the coroutine fills the buffer with values
+ * given to #batchYield, until the buffer is full or the coroutine finishes, and
+ * returns how many values were written. Once the coroutine has finished,
+ * invoking it again returns zero, and the next invocation after that restarts
+ * it from the beginning.
+ *
+ * This amortizes the cost of resuming the coroutine across many values, which
+ * is significant for fine-grained generators like tokenizers. Use
+ * #batchForEach to consume the values one at a time.
+ *
+ * @code
+
+__block int i;
+
+size_t (^squares)(int *, size_t, int) = batchCoroutine(int, int limit)({
+    for (i = 0;i < limit;++i) {
+        batchYield i * i;
+    }
+});
+
+int buffer[64];
+size_t count = squares(buffer, 64, 1000);
+
+ * @endcode
+ *
+ * @note The same rules about \c __block variables apply as with #coroutine.
+ * To yield objects under ARC, use <tt>__strong id</tt> (or another explicitly
+ * \c __strong type) as \a TYPE, so that the buffer retains them. See
+ * EXTCoroutineEnumerator for a way to consume such coroutines with
+ * <tt>for...in</tt>.
+ */
+#define batchCoroutine(...) \
+    ^{ \
+        __block unsigned long ext_coroutine_line_ = 0; \
+        \
+        return [ \
+            ^ size_t (metamacro_head(__VA_ARGS__) *ext_batchBuffer_, size_t ext_batchCapacity_ \
+                metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__)) \
+                    () \
+                    (, metamacro_tail(__VA_ARGS__)) \
+            ) batchCoroutine_body
+
+/**
+ * Adds a value to the buffer of a coroutine defined with #batchCoroutine. If
+ * the buffer is already full, this first returns from the coroutine, and adds
+ * the value once execution resumes.
+ *
+ * This macro can be used identically to #yield, but does not support \c void
+ * coroutines.
+ */
+#define batchYield \
+    if (ext_batchCount_ == ext_batchCapacity_) { \
+        ext_coroutine_line_ = __LINE__; \
+        return ext_batchCount_; \
+    } else case __LINE__: \
+        ext_batchBuffer_[ext_batchCount_++] =
+
+/**
+ * Iterates over every value produced by \a GENERATOR, a block as returned by
+ * #batchCoroutine that takes no arguments besides its buffer. Values are
+ * produced \a CAPACITY at a time into a buffer on the stack, and the following
+ * statement is executed for each one, with the value bound to a new variable
+ * \a VAR of type \a TYPE.
+ *
+ * \c break and \c continue behave as they would in any other loop. If the loop
+ * is exited early, the generator is left suspended, and will resume with the
+ * next value when it is invoked again.
+ *
+ * @code
+
+__block int i;
+
+size_t (^squares)(int *, size_t) = batchCoroutine(int)({
+    for (i = 0;i < 1000;++i) {
+        batchYield i * i;
+    }
+});
+
+batchForEach(int, square, 64, squares) {
+    NSLog(@"%i", square);
+}
+
+ * @endcode
+ *
+ * @warning Any values produced by the generator after the point where the loop
+ * was exited are discarded.
+ */
+#define batchForEach(TYPE, VAR, CAPACITY, GENERATOR) \
+    for (int ext_batchOnce_ = 1; ext_batchOnce_; ) \
+        for (TYPE ext_batchValues_[CAPACITY]; ext_batchOnce_; ext_batchOnce_ = 0) \
+            for (size_t ext_batchCount_ = 0, ext_batchIndex_ = 0, ext_batchBroken_ = 0, ext_batchValueOnce_ = 0; \
+                !ext_batchBroken_ && (ext_batchIndex_ < ext_batchCount_ || (ext_batchIndex_ = 0, ext_batchCount_ = (GENERATOR)(ext_batchValues_, (CAPACITY)), ext_batchCount_ > 0)); \
+            ) \
+                for (ext_batchBroken_ = 1, ext_batchValueOnce_ = 1; ext_batchValueOnce_; ext_batchValueOnce_ = 0) \
+                    for (TYPE VAR = ext_batchValues_[ext_batchIndex_++]; ext_batchBroken_; ext_batchBroken_ = 0)
+
+/**
+ * Defines a pipeline, which is a batched coroutine (as with #batchCoroutine)
+ * that passes the values produced by a loop through a series of stages.
+ *
+ * \a SOURCE is the head of a loop statement (such as a \c for or \c while
+ * clause), and \a VALUE is evaluated once per iteration of that loop to
+ * produce the next value. Each value is stored in a \c __block variable named
+ * \a VAR of type \a TYPE, which is declared by this macro, and then passed
+ * through each of the stages given as the remaining arguments, in order:
+ *
+ *  - <tt>map(EXPR)</tt> replaces \a VAR with the result of \a EXPR.
+ *  - <tt>filter(COND)</tt> drops the value unless \a COND is true.
+ *  - <tt>take(N)</tt> finishes the pipeline after \a N values have passed
+ *    through it.
+ *  - <tt>chunk(N)</tt> limits each invocation of the pipeline to producing at
+ *    most \a N values, so that the caller receives values in chunks of \a N.
+ *
+ * Values which make it through every stage are added to the caller's buffer.
+ * Stage names only have meaning within this macro, and do not need to be
+ * defined anywhere.
+ *
+ * Unlike chaining separate coroutines together, the stages are all expanded
+ * into a single loop at compile-time, so the cost of a pipeline does not grow
+ * with the number of stages, and the compiler is free to optimize across them.
+ *
+ * @code
+
+__block NSUInteger i;
+
+size_t (^evenSquares)(NSUInteger *, size_t) = pipeline(NSUInteger, x, for (i = 0;;++i), i,
+    filter(x % 2 == 0),
+    map(x * x),
+    take(10)
+);
+
+batchForEach(NSUInteger, square, 16, evenSquares) {
+    NSLog(@"%lu", (unsigned long)square);
+}
+
+ * @endcode
+ *
+ * At least one stage must be given. Up to nineteen stages are supported.
+ *
+ * @note The same rules about \c __block variables apply as with #coroutine.
+ * Stages can only refer to \a VAR and variables from the enclosing scope,
+ * and \a VAR keeps the same type throughout the pipeline.
+ */
+#define pipeline(TYPE, VAR, SOURCE, ...) \
+    ^{ \
+        __block unsigned long ext_coroutine_line_ = 0; \
+        __block TYPE VAR; \
+        __block struct { \
+            size_t counts[metamacro_argcount(__VA_ARGS__)]; \
+            int finishing; \
+        } ext_pipelineState_; \
+        \
+        return [ \
+            ^ size_t (TYPE *ext_batchBuffer_, size_t ext_batchCapacity_) \
+                batchCoroutine_body(ext_pipeline_body_(VAR, SOURCE, __VA_ARGS__))
+
 /*** implementation details follow ***/
 #define coroutine_body(STATEMENT) \
             { \
@@ -82,3 +252,80 @@ double y = myCoroutine(42, 2.0);
             } \
         copy]; \
     }()
+
+// if the coroutine finishes with values in the buffer, those are returned
+// first, and the next invocation returns zero
+#define batchCoroutine_body(STATEMENT) \
+            { \
+                size_t ext_batchCount_ = 0; \
+                \
+                switch (ext_coroutine_line_) { \
+                    default: \
+                        STATEMENT \
+                        \
+                        ext_coroutine_line_ = ULONG_MAX; \
+                        if (ext_batchCount_ > 0) \
+                            return ext_batchCount_; \
+                    \
+                    case ULONG_MAX: \
+                        ext_coroutine_line_ = 0; \
+                        return 0; \
+                } \
+            } \
+        copy]; \
+    }()
+
+// each stage is a statement prefix, so the stages are nested inside one
+// another, with batchYield as the innermost statement
+#define ext_pipeline_body_(VAR, SOURCE, ...) \
+    { \
+        memset(&ext_pipelineState_, 0, sizeof(ext_pipelineState_)); \
+        \
+        SOURCE { \
+            VAR = (metamacro_head(__VA_ARGS__)); \
+            \
+            metamacro_foreach_cxt(ext_pipelineStage_, , VAR, metamacro_tail(__VA_ARGS__)) \
+            { \
+                batchYield VAR; \
+                \
+                if (ext_pipelineState_.finishing) \
+                    goto ext_pipelineFinished_; \
+            } \
+        } \
+        \
+    ext_pipelineFinished_: __attribute__((unused)) \
+        ; \
+    }
+
+// pastes the name of the stage onto ext_pipelineStage_, which turns it into an
+// invocation of one of the stage macros below
+#define ext_pipelineStage_(INDEX, VAR, STAGE) \
+    ext_pipelineStageApply_(INDEX, VAR, ext_pipelineStage_ ## STAGE)
+
+#define ext_pipelineStageApply_(INDEX, VAR, STAGE) \
+    ext_pipelineStageApply__(INDEX, VAR, STAGE)
+
+#define ext_pipelineStageApply__(INDEX, VAR, MACRO, ...) \
+    MACRO(INDEX, VAR, __VA_ARGS__)
+
+#define ext_pipelineStage_map(...) ext_pipelineMap_, __VA_ARGS__
+#define ext_pipelineStage_filter(...) ext_pipelineFilter_, __VA_ARGS__
+#define ext_pipelineStage_take(N) ext_pipelineTake_, N
+#define ext_pipelineStage_chunk(N) ext_pipelineChunk_, N
+
+#define ext_pipelineMap_(INDEX, VAR, ...) \
+    if ((VAR) = (__VA_ARGS__), 0) {} else
+
+#define ext_pipelineFilter_(INDEX, VAR, ...) \
+    if (!(__VA_ARGS__)) {} else
+
+// the count is checked before and after the value is added to the buffer, so
+// that the pipeline finishes as soon as the last value is taken, and values
+// that arrive after that (e.g., through an earlier stage) are dropped
+#define ext_pipelineTake_(INDEX, VAR, N) \
+    if (ext_pipelineState_.counts[INDEX] >= (size_t)(N)) \
+        goto ext_pipelineFinished_; \
+    else if (ext_pipelineState_.finishing |= (++ext_pipelineState_.counts[INDEX] >= (size_t)(N)), 0) {} else
+
+#define ext_pipelineChunk_(INDEX, VAR, N) \
+    if (ext_batchCapacity_ > (size_t)(N) ? (void)(ext_batchCapacity_ = (size_t)(N)), 0 : 0) {} else
@@ -0,0 +1,71 @@
+//
+//  EXTCoroutineEnumerator.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * A batched coroutine which produces objects, as defined by
+ * <tt>batchCoroutine(__strong id)</tt>.
+ */
+typedef size_t (^ext_objectGenerator)(__strong id *values, size_t capacity);
+
+/**
+ * An enumerator over the objects produced by a batched coroutine, which
+ * generates them lazily as the enumeration proceeds.
+ *
+ * Fast enumeration resumes the coroutine once for every batch of objects,
+ * rather than once per object, and hands the batch to the \c for...in loop
+ * directly, so that lazily generated sequences can be iterated at close to the
+ * speed of an \c NSArray.
+ *
+ * @code
+
+__block NSUInteger i;
+
+EXTCoroutineEnumerator *numbers = [EXTCoroutineEnumerator enumeratorWithGenerator:batchCoroutine(__strong id)({
+    for (i = 0;i < 1000;++i) {
+        batchYield @(i);
+    }
+})];
+
+for (NSNumber *number in numbers) {
+    NSLog(@"%@", number);
+}
+
+ * @endcode
+ *
+ * Like any \c NSEnumerator, this can only be enumerated once.
+ *
+ * @note This header doesn't import EXTCoroutine.h, since its macros would leak
+ * into every file using the extobjc.h umbrella header. Import it separately
+ * where generators are written.
+ */
+@interface EXTCoroutineEnumerator : NSEnumerator
+
+/**
+ * Returns an enumerator over the objects produced by \a generator, which are
+ * generated in batches of a default size.
+ */
++ (instancetype)enumeratorWithGenerator:(ext_objectGenerator)generator;
+
+/**
+ * Initializes an enumerator over the objects produced by \a generator, which
+ * are generated up to \a batchSize at a time. \a batchSize must be greater than
+ * zero.
+ *
+ * The most recent batch of objects is retained by the enumerator until the
+ * next batch is generated.
+ */
+- (id)initWithGenerator:(ext_objectGenerator)generator batchSize:(NSUInteger)batchSize;
+
+/**
+ * The maximum number of objects generated at a time.
+ */
+@property (nonatomic, readonly) NSUInteger batchSize;
+
+@end
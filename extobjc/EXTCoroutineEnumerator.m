@@ -0,0 +1,131 @@
+//
+//  EXTCoroutineEnumerator.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTCoroutineEnumerator.h"
+#import <stdlib.h>
+
+// large enough to amortize the cost of resuming the coroutine, while staying
+// within a few cache lines
+static const NSUInteger EXTCoroutineEnumeratorDefaultBatchSize = 64;
+
+@implementation EXTCoroutineEnumerator {
+    ext_objectGenerator _generator;
+
+    // the current batch of objects, which are retained
+    __strong id *_values;
+
+    // the number of objects in the current batch
+    size_t _count;
+
+    // the index of the next object to be returned from -nextObject
+    size_t _index;
+
+    // whether the coroutine has finished
+    BOOL _finished;
+}
+
++ (instancetype)enumeratorWithGenerator:(ext_objectGenerator)generator {
+    return [[self alloc] initWithGenerator:generator batchSize:EXTCoroutineEnumeratorDefaultBatchSize];
+}
+
+- (id)initWithGenerator:(ext_objectGenerator)generator batchSize:(NSUInteger)batchSize {
+    NSParameterAssert(generator != nil);
+    NSParameterAssert(batchSize > 0);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    _values = (__strong id *)calloc(batchSize, sizeof(*_values));
+    if (!_values)
+        return nil;
+
+    _generator = [generator copy];
+    _batchSize = batchSize;
+
+    return self;
+}
+
+- (void)dealloc {
+    if (!_values)
+        return;
+
+    for (size_t i = 0;i < _count;++i) {
+        _values[i] = nil;
+    }
+
+    free(_values);
+}
+
+/**
+ * Resumes the coroutine to replace the current batch of objects. Returns the
+ * number of objects in the new batch, which is zero once the coroutine has
+ * finished.
+ */
+- (size_t)generateBatch {
+    if (_finished)
+        return 0;
+
+    size_t count = _generator(_values, _batchSize);
+
+    // release anything left over from the previous batch
+    for (size_t i = count;i < _count;++i) {
+        _values[i] = nil;
+    }
+
+    _count = count;
+    _index = 0;
+
+    if (!count) {
+        _finished = YES;
+
+        // don't hold onto anything captured by the coroutine
+        _generator = nil;
+    }
+
+    return count;
+}
+
+#pragma mark NSEnumerator
+
+- (id)nextObject {
+    if (_index == _count && ![self generateBatch])
+        return nil;
+
+    return _values[_index++];
+}
+
+#pragma mark NSFastEnumeration
+
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state objects:(id __unsafe_unretained [])buffer count:(NSUInteger)len {
+    if (state->state == 0) {
+        // we don't support mutation, but mutationsPtr still needs to point to
+        // something that won't change
+        state->mutationsPtr = &state->extra[0];
+        state->state = 1;
+
+        if (_index < _count) {
+            // start with whatever hasn't been returned by -nextObject yet
+            state->itemsPtr = (__unsafe_unretained id *)(void *)(_values + _index);
+
+            NSUInteger remaining = _count - _index;
+            _index = _count;
+            return remaining;
+        }
+    }
+
+    // the objects returned from the previous call are no longer needed, so the
+    // coroutine can write directly over them
+    size_t count = [self generateBatch];
+    _index = count;
+
+    state->itemsPtr = (__unsafe_unretained id *)(void *)_values;
+    return count;
+}
+
+@end
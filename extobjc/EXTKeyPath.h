@@ -0,0 +1,199 @@
+//
+//  EXTKeyPath.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+#import "EXTKeyPathCoding.h"
+
+/**
+ * A key path which has been parsed ahead of time, and which can be evaluated
+ * much faster than with \c -valueForKeyPath:.
+ *
+ * Each time \c -valueForKeyPath: is invoked, key-value coding splits the path
+ * into keys, searches each object's class for an accessor method matching each
+ * key, and boxes any scalar values into \c NSNumber objects. An #EXTKeyPath
+ * splits its path once, when it is created, and remembers the accessor method
+ * (and its return type) found for each key on the last couple of classes it
+ * was evaluated against. Evaluating it again with objects of the same classes
+ * calls those methods directly.
+ *
+ * The typed methods, like #doubleValueForObject:, call the accessor for the
+ * last key with its actual return type, so that scalar properties can be read
+ * without boxing them.
+ *
+ * @code
+
+EXTKeyPath *agePath = @compiledKeypath(Person.new, age);
+
+NSInteger totalAge = 0;
+for (Person *person in people) {
+    totalAge += [agePath integerValueForObject:person];
+}
+
+ * @endcode
+ *
+ * To evaluate a key path for a large array of objects, such as to extract
+ * a column of values from a collection of model objects, use the bulk
+ * evaluation methods like #getDoubleValues:forObjects:, which fill a C array
+ * using multiple threads.
+ *
+ * Accessors are found in the same order as with key-value coding (\c
+ * -get<Key>, \c -<key>, \c -is<Key>, and \c -_<key>). Anything else is left to
+ * key-value coding: keys without a matching accessor (such as those backed
+ * only by instance variables), accessors returning types other than objects
+ * and numbers, objects which override \c -valueForKey: (such as collections and
+ * dictionaries), and key paths using collection operators like \c \@sum.
+ *
+ * Key paths are immutable, and can be evaluated from any number of threads at
+ * once.
+ *
+ * @warning Accessor methods are looked up the first time a key path is
+ * evaluated against each class, so methods which are added or replaced
+ * afterward will not be noticed by that key path.
+ */
+@interface EXTKeyPath : NSObject <NSCopying>
+
+/**
+ * Returns a key path parsed from \a string, which is a sequence of keys
+ * separated by periods, like the strings created by \@keypath.
+ */
++ (instancetype)keyPathWithString:(NSString *)string;
+
+/**
+ * Initializes a key path parsed from \a string, which is a sequence of keys
+ * separated by periods, like the strings created by \@keypath.
+ */
+- (id)initWithString:(NSString *)string;
+
+/**
+ * The string from which this key path was parsed.
+ */
+@property (nonatomic, copy, readonly) NSString *string;
+
+/**
+ * Returns the same value as <tt>[object valueForKeyPath:self.string]</tt>,
+ * including boxing the result if it's a scalar. Returns \c nil if \a object,
+ * or any intermediate value, is \c nil.
+ */
+- (id)valueForObject:(id)object;
+
+/**
+ * Returns the value of this key path for \a object, converted to an \c
+ * NSInteger. If the value is an object, it is sent \c -integerValue.
+ *
+ * Returns zero if \a object, or any intermediate value, is \c nil.
+ */
+- (NSInteger)integerValueForObject:(id)object;
+
+/**
+ * Returns the value of this key path for \a object, converted to an \c
+ * NSUInteger. If the value is an object, it is sent \c -unsignedIntegerValue.
+ *
+ * Returns zero if \a object, or any intermediate value, is \c nil.
+ */
+- (NSUInteger)unsignedIntegerValueForObject:(id)object;
+
+/**
+ * Returns the value of this key path for \a object, converted to a \c double.
+ * If the value is an object, it is sent \c -doubleValue.
+ *
+ * Returns zero if \a object, or any intermediate value, is \c nil.
+ */
+- (double)doubleValueForObject:(id)object;
+
+/**
+ * Returns the value of this key path for \a object, converted to a \c BOOL. If
+ * the value is an object, it is sent \c -boolValue.
+ *
+ * Returns \c NO if \a object, or any intermediate value, is \c nil.
+ */
+- (BOOL)boolValueForObject:(id)object;
+
+/**
+ * Stores the value of this key path for each of \a objects into the
+ * corresponding element of \a values, as if by #valueForObject:.
+ *
+ * \a values must have room for <tt>objects.count</tt> elements, each of which
+ * must be initialized (such as to \c nil), since any existing values are
+ * released as they're replaced.
+ *
+ * Like the other bulk evaluation methods, this avoids looking up the accessor
+ * for the last key again while consecutive objects are of the same class, and
+ * splits large arrays across multiple threads, so accessors must be safe to
+ * invoke concurrently (as most getters are). Values are stored in the same
+ * order as \a objects regardless.
+ */
+- (void)getValues:(__strong id *)values forObjects:(NSArray *)objects;
+
+/**
+ * Stores the value of this key path for each of \a objects into the
+ * corresponding element of \a values, which must have room for
+ * <tt>objects.count</tt> elements, as if by #integerValueForObject:.
+ *
+ * See #getValues:forObjects: for more information.
+ */
+- (void)getIntegerValues:(NSInteger *)values forObjects:(NSArray *)objects;
+
+/**
+ * Stores the value of this key path for each of \a objects into the
+ * corresponding element of \a values, which must have room for
+ * <tt>objects.count</tt> elements, as if by #unsignedIntegerValueForObject:.
+ *
+ * See #getValues:forObjects: for more information.
+ */
+- (void)getUnsignedIntegerValues:(NSUInteger *)values forObjects:(NSArray *)objects;
+
+/**
+ * Stores the value of this key path for each of \a objects into the
+ * corresponding element of \a values, which must have room for
+ * <tt>objects.count</tt> elements, as if by #doubleValueForObject:.
+ *
+ * See #getValues:forObjects: for more information.
+ */
+- (void)getDoubleValues:(double *)values forObjects:(NSArray *)objects;
+
+/**
+ * Stores the value of this key path for each of \a objects into the
+ * corresponding element of \a values, which must have room for
+ * <tt>objects.count</tt> elements, as if by #boolValueForObject:.
+ *
+ * See #getValues:forObjects: for more information.
+ */
+- (void)getBoolValues:(BOOL *)values forObjects:(NSArray *)objects;
+
+@end
+
+/**
+ * Creates an #EXTKeyPath from the same arguments as \@keypath, verifying the
+ * key path at compile-time in the same way. The key path is created once, the
+ * first time each use of the macro is evaluated, so its cached accessors are
+ * shared by every evaluation of that use.
+ *
+ * @code
+
+EXTKeyPath *lengthPath = @compiledKeypath(person.name.length);
+// => an EXTKeyPath for @"name.length"
+
+ * @endcode
+ */
+#define compiledKeypath(...) \
+    _Pragma("clang diagnostic push") \
+    _Pragma("clang diagnostic ignored \"-Warc-repeated-use-of-weak\"") \
+    (NO).boolValue ? ((EXTKeyPath * _Nonnull)nil) : ((EXTKeyPath * _Nonnull)cachedCompiledKeypath(objcKeypath(__VA_ARGS__))) \
+    _Pragma("clang diagnostic pop") \
+
+/*** implementation details follow ***/
+#define cachedCompiledKeypath(STRING) \
+    ({ \
+        static EXTKeyPath *__extobjccompiledkeypath__ = nil; \
+        static dispatch_once_t __extobjccompiledkeypathonce__; \
+        NSString *__extobjccompiledkeypathstring__ = (STRING); \
+        dispatch_once(&__extobjccompiledkeypathonce__, ^{ \
+            __extobjccompiledkeypath__ = [[EXTKeyPath alloc] initWithString:__extobjccompiledkeypathstring__]; \
+        }); \
+        __extobjccompiledkeypath__; \
+    })
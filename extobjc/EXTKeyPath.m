@@ -0,0 +1,541 @@
+//
+//  EXTKeyPath.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTKeyPath.h"
+#import <objc/runtime.h>
+#import <stdatomic.h>
+#import <stdlib.h>
+#import <string.h>
+
+// the number of classes for which each key caches its accessor, all of which
+// are checked on every evaluation
+#define EXT_KEYPATH_CACHE_SIZE 2
+
+// the maximum number of accessors which can be cached for each key, after
+// which accessors for any new classes are looked up on every evaluation
+#define EXT_KEYPATH_MAXIMUM_ACCESSORS 8
+
+// the number of objects evaluated by each thread when evaluating a key path
+// for many objects at once
+#define EXT_KEYPATH_CHUNK_SIZE 8192
+
+// the number of objects copied out of an array at a time
+#define EXT_KEYPATH_BATCH_SIZE 256
+
+/*
+ * How the value for a key is retrieved.
+ */
+typedef enum {
+    ext_keyPathTypeObject = 0,
+    ext_keyPathTypeChar,
+    ext_keyPathTypeUnsignedChar,
+    ext_keyPathTypeShort,
+    ext_keyPathTypeUnsignedShort,
+    ext_keyPathTypeInt,
+    ext_keyPathTypeUnsignedInt,
+    ext_keyPathTypeLong,
+    ext_keyPathTypeUnsignedLong,
+    ext_keyPathTypeLongLong,
+    ext_keyPathTypeUnsignedLongLong,
+    ext_keyPathTypeFloat,
+    ext_keyPathTypeDouble,
+    ext_keyPathTypeBool,
+
+    // the value is retrieved with -valueForKey:
+    ext_keyPathTypeKeyValueCoding
+} ext_keyPathType;
+
+/*
+ * The method used to retrieve the value for a key from instances of a class.
+ */
+typedef struct {
+    __unsafe_unretained Class cls;
+    SEL selector;
+    IMP implementation;
+    ext_keyPathType type;
+} ext_keyPathAccessor;
+
+typedef struct {
+    // owned by the key path's array of keys
+    __unsafe_unretained NSString *key;
+
+    // pointers into the accessors array, published once the accessor has been
+    // completely written
+    _Atomic(const ext_keyPathAccessor *) cache[EXT_KEYPATH_CACHE_SIZE];
+    atomic_uint nextCacheIndex;
+
+    // accessors are never changed or removed once they have been added, so
+    // that threads evaluating the key path never see them half-written
+    atomic_uint accessorCount;
+    ext_keyPathAccessor accessors[EXT_KEYPATH_MAXIMUM_ACCESSORS];
+} ext_keyPathComponent;
+
+/**
+ * Returns the type of values returned by a method with the given return type
+ * encoding.
+ */
+static ext_keyPathType ext_keyPathTypeFromEncoding (const char *encoding) {
+    // skip type qualifiers, like const
+    while (*encoding && strchr("rnNoORV", *encoding))
+        ++encoding;
+
+    switch (*encoding) {
+        case '@': return ext_keyPathTypeObject;
+        case 'c': return ext_keyPathTypeChar;
+        case 'C': return ext_keyPathTypeUnsignedChar;
+        case 's': return ext_keyPathTypeShort;
+        case 'S': return ext_keyPathTypeUnsignedShort;
+        case 'i': return ext_keyPathTypeInt;
+        case 'I': return ext_keyPathTypeUnsignedInt;
+        case 'l': return ext_keyPathTypeLong;
+        case 'L': return ext_keyPathTypeUnsignedLong;
+        case 'q': return ext_keyPathTypeLongLong;
+        case 'Q': return ext_keyPathTypeUnsignedLongLong;
+        case 'f': return ext_keyPathTypeFloat;
+        case 'd': return ext_keyPathTypeDouble;
+        case 'B': return ext_keyPathTypeBool;
+
+        // structures, pointers, etc., which key-value coding knows how to box
+        default: return ext_keyPathTypeKeyValueCoding;
+    }
+}
+
+/**
+ * Finds the accessor which key-value coding would use to get the value for \a
+ * key from instances of \a cls, and stores it into \a accessor.
+ */
+static void ext_keyPathResolveAccessor (Class cls, NSString *key, ext_keyPathAccessor *accessor) {
+    accessor->cls = cls;
+    accessor->selector = @selector(valueForKey:);
+    accessor->implementation = class_getMethodImplementation(cls, @selector(valueForKey:));
+    accessor->type = ext_keyPathTypeKeyValueCoding;
+
+    // collections and dictionaries (among others) have their own ideas about
+    // what keys mean
+    if (accessor->implementation != class_getMethodImplementation([NSObject class], @selector(valueForKey:)))
+        return;
+
+    if (key.length == 0)
+        return;
+
+    NSString *capitalizedKey = [[key substringToIndex:1].uppercaseString stringByAppendingString:[key substringFromIndex:1]];
+
+    // in the same order as key-value coding
+    NSString *selectorNames[] = {
+        [@"get" stringByAppendingString:capitalizedKey],
+        key,
+        [@"is" stringByAppendingString:capitalizedKey],
+        [@"_" stringByAppendingString:key]
+    };
+
+    for (size_t i = 0;i < sizeof(selectorNames) / sizeof(*selectorNames);++i) {
+        SEL selector = NSSelectorFromString(selectorNames[i]);
+
+        Method method = class_getInstanceMethod(cls, selector);
+        if (!method || method_getNumberOfArguments(method) != 2)
+            continue;
+
+        char *returnType = method_copyReturnType(method);
+        ext_keyPathType type = ext_keyPathTypeFromEncoding(returnType);
+        free(returnType);
+
+        // key-value coding would use this accessor even if we don't know how
+        // to call it, so stop looking either way
+        if (type != ext_keyPathTypeKeyValueCoding) {
+            accessor->selector = selector;
+            accessor->implementation = method_getImplementation(method);
+            accessor->type = type;
+        }
+
+        return;
+    }
+}
+
+/**
+ * Looks up and caches the accessor for \a cls, after it wasn't found in the
+ * cache of \a component. If no more accessors can be cached, \a uncached is
+ * filled in and returned instead.
+ */
+static __attribute__((noinline)) const ext_keyPathAccessor *ext_keyPathComponentCacheMiss (ext_keyPathComponent *component, Class cls, ext_keyPathAccessor *uncached) {
+    ext_keyPathResolveAccessor(cls, component->key, uncached);
+
+    unsigned index = atomic_load_explicit(&component->accessorCount, memory_order_relaxed);
+    do {
+        if (index >= EXT_KEYPATH_MAXIMUM_ACCESSORS)
+            return uncached;
+    } while (!atomic_compare_exchange_weak_explicit(&component->accessorCount, &index, index + 1, memory_order_relaxed, memory_order_relaxed));
+
+    ext_keyPathAccessor *accessor = component->accessors + index;
+    memcpy(accessor, uncached, sizeof(*accessor));
+
+    unsigned cacheIndex = atomic_fetch_add_explicit(&component->nextCacheIndex, 1, memory_order_relaxed) % EXT_KEYPATH_CACHE_SIZE;
+    atomic_store_explicit(&component->cache[cacheIndex], accessor, memory_order_release);
+
+    return accessor;
+}
+
+/**
+ * Returns the accessor for the key of \a component on the class of \a object,
+ * which must not be \c nil. \a uncached is used as storage if the accessor can't
+ * be cached.
+ */
+static inline const ext_keyPathAccessor *ext_keyPathComponentAccessor (ext_keyPathComponent *component, id object, ext_keyPathAccessor *uncached) {
+    Class cls = object_getClass(object);
+
+    for (unsigned i = 0;i < EXT_KEYPATH_CACHE_SIZE;++i) {
+        const ext_keyPathAccessor *accessor = atomic_load_explicit(&component->cache[i], memory_order_acquire);
+        if (accessor && accessor->cls == cls)
+            return accessor;
+    }
+
+    return ext_keyPathComponentCacheMiss(component, cls, uncached);
+}
+
+// invokes the accessor, which must return TYPE
+#define ext_keyPathCall(ACCESSOR, OBJECT, TYPE) \
+    ((TYPE (*)(id, SEL))(ACCESSOR)->implementation)((OBJECT), (ACCESSOR)->selector)
+
+// invokes -valueForKey:, or an override of it
+#define ext_keyPathCallValueForKey(ACCESSOR, OBJECT, KEY) \
+    ((id (*)(id, SEL, NSString *))(ACCESSOR)->implementation)((OBJECT), (ACCESSOR)->selector, (KEY))
+
+// switch cases which return the result of a scalar accessor, passed through
+// CONVERT
+#define ext_keyPathScalarCases(ACCESSOR, OBJECT, CONVERT) \
+    case ext_keyPathTypeChar: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, char)); \
+    case ext_keyPathTypeUnsignedChar: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, unsigned char)); \
+    case ext_keyPathTypeShort: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, short)); \
+    case ext_keyPathTypeUnsignedShort: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, unsigned short)); \
+    case ext_keyPathTypeInt: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, int)); \
+    case ext_keyPathTypeUnsignedInt: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, unsigned int)); \
+    case ext_keyPathTypeLong: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, long)); \
+    case ext_keyPathTypeUnsignedLong: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, unsigned long)); \
+    case ext_keyPathTypeLongLong: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, long long)); \
+    case ext_keyPathTypeUnsignedLongLong: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, unsigned long long)); \
+    case ext_keyPathTypeFloat: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, float)); \
+    case ext_keyPathTypeDouble: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, double)); \
+    case ext_keyPathTypeBool: return CONVERT(ext_keyPathCall(ACCESSOR, OBJECT, _Bool));
+
+#define ext_keyPathBox(VALUE) @(VALUE)
+#define ext_keyPathIsNonzero(VALUE) ((VALUE) != 0)
+
+/**
+ * Returns the value retrieved by \a accessor for \a key from \a object, boxing
+ * it if necessary.
+ */
+static inline id ext_keyPathAccessorObjectValue (const ext_keyPathAccessor *accessor, id object, NSString *key) {
+    switch (accessor->type) {
+        case ext_keyPathTypeObject:
+            return ext_keyPathCall(accessor, object, id);
+
+        case ext_keyPathTypeKeyValueCoding:
+            return ext_keyPathCallValueForKey(accessor, object, key);
+
+        ext_keyPathScalarCases(accessor, object, ext_keyPathBox)
+    }
+
+    return nil;
+}
+
+/**
+ * Generates a function which returns the value retrieved by an accessor,
+ * converted to TYPE. Scalars are converted with CONVERT, and objects are sent
+ * MESSAGE.
+ */
+#define ext_keyPathScalarValueFunction(NAME, TYPE, CONVERT, MESSAGE) \
+    static inline TYPE NAME (const ext_keyPathAccessor *accessor, id object, NSString *key) { \
+        switch (accessor->type) { \
+            case ext_keyPathTypeObject: \
+                return [ext_keyPathCall(accessor, object, id) MESSAGE]; \
+            \
+            case ext_keyPathTypeKeyValueCoding: \
+                return [ext_keyPathCallValueForKey(accessor, object, key) MESSAGE]; \
+            \
+            ext_keyPathScalarCases(accessor, object, CONVERT) \
+        } \
+        \
+        return 0; \
+    }
+
+ext_keyPathScalarValueFunction(ext_keyPathAccessorIntegerValue, NSInteger, (NSInteger), integerValue)
+ext_keyPathScalarValueFunction(ext_keyPathAccessorUnsignedIntegerValue, NSUInteger, (NSUInteger), unsignedIntegerValue)
+ext_keyPathScalarValueFunction(ext_keyPathAccessorDoubleValue, double, (double), doubleValue)
+ext_keyPathScalarValueFunction(ext_keyPathAccessorBoolValue, BOOL, ext_keyPathIsNonzero, boolValue)
+
+/**
+ * Returns the value of the key of \a component for \a object, which must not be
+ * \c nil, using VALUE_FUNCTION to retrieve it.
+ */
+#define ext_keyPathComponentValue(COMPONENT, OBJECT, VALUE_FUNCTION) \
+    ({ \
+        ext_keyPathAccessor ext_uncached_; \
+        VALUE_FUNCTION(ext_keyPathComponentAccessor((COMPONENT), (OBJECT), &ext_uncached_), (OBJECT), (COMPONENT)->key); \
+    })
+
+/**
+ * Returns the value of the key of \a component for \a object, which must not be
+ * \c nil, boxing it if necessary.
+ */
+static id ext_keyPathObjectValue (ext_keyPathComponent *component, id object) {
+    return ext_keyPathComponentValue(component, object, ext_keyPathAccessorObjectValue);
+}
+
+/**
+ * Evaluates all but the last of the \a count components, and returns the object
+ * from which the last key's value should be retrieved, or \c nil if \a object
+ * or any of the intermediate values are \c nil.
+ */
+static inline id ext_keyPathTarget (ext_keyPathComponent *components, size_t count, id object) {
+    for (size_t i = 0;i + 1 < count && object;++i) {
+        object = ext_keyPathObjectValue(components + i, object);
+    }
+
+    return object;
+}
+
+/**
+ * Generates a function which stores the value of the key path made up of \a
+ * componentCount components for each of the \a count \a objects into \a
+ * values, using VALUE_FUNCTION for the last key.
+ *
+ * Consecutive objects of the same class use the same accessor for the last
+ * key, without checking the cache again.
+ *
+ * If \a fallbackPath is not \c nil, it's evaluated for each object with \c
+ * -valueForKeyPath: instead, and the result is sent MESSAGE.
+ */
+#define ext_keyPathColumnFunction(NAME, TYPE, VALUE_FUNCTION, MESSAGE) \
+    static void NAME (ext_keyPathComponent *components, size_t componentCount, NSString *fallbackPath, __unsafe_unretained id *objects, TYPE *values, size_t count) { \
+        if (fallbackPath) { \
+            for (size_t i = 0;i < count;++i) { \
+                values[i] = [[objects[i] valueForKeyPath:fallbackPath] MESSAGE]; \
+            } \
+            \
+            return; \
+        } \
+        \
+        ext_keyPathComponent *component = components + componentCount - 1; \
+        Class previousClass = Nil; \
+        const ext_keyPathAccessor *accessor = NULL; \
+        ext_keyPathAccessor uncached; \
+        \
+        for (size_t i = 0;i < count;++i) { \
+            id target = ext_keyPathTarget(components, componentCount, objects[i]); \
+            if (!target) { \
+                values[i] = 0; \
+                continue; \
+            } \
+            \
+            Class cls = object_getClass(target); \
+            if (cls != previousClass) { \
+                accessor = ext_keyPathComponentAccessor(component, target, &uncached); \
+                previousClass = cls; \
+            } \
+            \
+            values[i] = VALUE_FUNCTION(accessor, target, component->key); \
+        } \
+    }
+
+ext_keyPathColumnFunction(ext_keyPathIntegerColumn, NSInteger, ext_keyPathAccessorIntegerValue, integerValue)
+ext_keyPathColumnFunction(ext_keyPathUnsignedIntegerColumn, NSUInteger, ext_keyPathAccessorUnsignedIntegerValue, unsignedIntegerValue)
+ext_keyPathColumnFunction(ext_keyPathDoubleColumn, double, ext_keyPathAccessorDoubleValue, doubleValue)
+ext_keyPathColumnFunction(ext_keyPathBoolColumn, BOOL, ext_keyPathAccessorBoolValue, boolValue)
+
+// objects are "converted" by sending them -self
+ext_keyPathColumnFunction(ext_keyPathObjectColumn, __strong id, ext_keyPathAccessorObjectValue, self)
+
+/**
+ * Invokes \a block with consecutive batches of the objects in \a array, along
+ * with the index of the first object in each batch. If there are enough
+ * objects, the array is split into chunks which are processed concurrently.
+ */
+static void ext_keyPathEnumerateBatches (NSArray *array, void (^block)(__unsafe_unretained id *objects, size_t start, size_t count)) {
+    size_t count = array.count;
+    size_t chunkCount = (count + EXT_KEYPATH_CHUNK_SIZE - 1) / EXT_KEYPATH_CHUNK_SIZE;
+
+    void (^processChunk)(size_t) = ^(size_t chunk){
+        __unsafe_unretained id objects[EXT_KEYPATH_BATCH_SIZE];
+        size_t end = MIN(count, (chunk + 1) * EXT_KEYPATH_CHUNK_SIZE);
+
+        for (size_t start = chunk * EXT_KEYPATH_CHUNK_SIZE;start < end;start += EXT_KEYPATH_BATCH_SIZE) {
+            size_t batchCount = MIN(end - start, (size_t)EXT_KEYPATH_BATCH_SIZE);
+
+            [array getObjects:objects range:NSMakeRange(start, batchCount)];
+            block(objects, start, batchCount);
+        }
+    };
+
+    if (chunkCount > 1)
+        dispatch_apply(chunkCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), processChunk);
+    else if (chunkCount == 1)
+        processChunk(0);
+}
+
+@implementation EXTKeyPath {
+    NSArray *_keys;
+
+    // one for each key
+    ext_keyPathComponent *_components;
+    size_t _count;
+
+    // whether the key path uses features which aren't supported here, like
+    // collection operators, and should just be passed to -valueForKeyPath:
+    BOOL _usesKeyValueCoding;
+}
+
++ (instancetype)keyPathWithString:(NSString *)string {
+    return [[self alloc] initWithString:string];
+}
+
+- (id)initWithString:(NSString *)string {
+    NSParameterAssert(string != nil);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    _string = [string copy];
+    _keys = [_string componentsSeparatedByString:@"."];
+    _count = _keys.count;
+
+    _components = calloc(_count, sizeof(*_components));
+    if (!_components)
+        return nil;
+
+    for (size_t i = 0;i < _count;++i) {
+        _components[i].key = [_keys objectAtIndex:i];
+    }
+
+    _usesKeyValueCoding = ([_string rangeOfString:@"@"].location != NSNotFound);
+    return self;
+}
+
+- (void)dealloc {
+    free(_components);
+}
+
+- (id)valueForObject:(id)object {
+    if (_usesKeyValueCoding)
+        return [object valueForKeyPath:_string];
+
+    object = ext_keyPathTarget(_components, _count, object);
+    if (!object)
+        return nil;
+
+    return ext_keyPathObjectValue(_components + _count - 1, object);
+}
+
+- (NSInteger)integerValueForObject:(id)object {
+    if (_usesKeyValueCoding)
+        return [[object valueForKeyPath:_string] integerValue];
+
+    object = ext_keyPathTarget(_components, _count, object);
+    if (!object)
+        return 0;
+
+    return ext_keyPathComponentValue(_components + _count - 1, object, ext_keyPathAccessorIntegerValue);
+}
+
+- (NSUInteger)unsignedIntegerValueForObject:(id)object {
+    if (_usesKeyValueCoding)
+        return [[object valueForKeyPath:_string] unsignedIntegerValue];
+
+    object = ext_keyPathTarget(_components, _count, object);
+    if (!object)
+        return 0;
+
+    return ext_keyPathComponentValue(_components + _count - 1, object, ext_keyPathAccessorUnsignedIntegerValue);
+}
+
+- (double)doubleValueForObject:(id)object {
+    if (_usesKeyValueCoding)
+        return [[object valueForKeyPath:_string] doubleValue];
+
+    object = ext_keyPathTarget(_components, _count, object);
+    if (!object)
+        return 0;
+
+    return ext_keyPathComponentValue(_components + _count - 1, object, ext_keyPathAccessorDoubleValue);
+}
+
+- (BOOL)boolValueForObject:(id)object {
+    if (_usesKeyValueCoding)
+        return [[object valueForKeyPath:_string] boolValue];
+
+    object = ext_keyPathTarget(_components, _count, object);
+    if (!object)
+        return NO;
+
+    return ext_keyPathComponentValue(_components + _count - 1, object, ext_keyPathAccessorBoolValue);
+}
+
+#pragma mark Bulk evaluation
+
+/**
+ * Generates the body of a method which stores the values of this key path for
+ * OBJECTS into VALUES with COLUMN_FUNCTION.
+ */
+#define EXTKeyPathColumnMethodBody(COLUMN_FUNCTION, VALUES, OBJECTS) \
+    NSParameterAssert(VALUES != NULL || (OBJECTS).count == 0); \
+    \
+    ext_keyPathComponent *components = _components; \
+    size_t componentCount = _count; \
+    NSString *fallbackPath = (_usesKeyValueCoding ? _string : nil); \
+    \
+    ext_keyPathEnumerateBatches((OBJECTS), ^(__unsafe_unretained id *batch, size_t start, size_t count){ \
+        COLUMN_FUNCTION(components, componentCount, fallbackPath, batch, VALUES + start, count); \
+    });
+
+- (void)getValues:(__strong id *)values forObjects:(NSArray *)objects {
+    EXTKeyPathColumnMethodBody(ext_keyPathObjectColumn, values, objects)
+}
+
+- (void)getIntegerValues:(NSInteger *)values forObjects:(NSArray *)objects {
+    EXTKeyPathColumnMethodBody(ext_keyPathIntegerColumn, values, objects)
+}
+
+- (void)getUnsignedIntegerValues:(NSUInteger *)values forObjects:(NSArray *)objects {
+    EXTKeyPathColumnMethodBody(ext_keyPathUnsignedIntegerColumn, values, objects)
+}
+
+- (void)getDoubleValues:(double *)values forObjects:(NSArray *)objects {
+    EXTKeyPathColumnMethodBody(ext_keyPathDoubleColumn, values, objects)
+}
+
+- (void)getBoolValues:(BOOL *)values forObjects:(NSArray *)objects {
+    EXTKeyPathColumnMethodBody(ext_keyPathBoolColumn, values, objects)
+}
+
+#pragma mark NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    // key paths are immutable
+    return self;
+}
+
+#pragma mark NSObject
+
+- (NSUInteger)hash {
+    return _string.hash;
+}
+
+- (BOOL)isEqual:(EXTKeyPath *)keyPath {
+    if (self == keyPath)
+        return YES;
+
+    if (![keyPath isKindOfClass:[EXTKeyPath class]])
+        return NO;
+
+    return [_string isEqualToString:keyPath.string];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> %@", self.class, self, _string];
+}
+
+@end
@@ -34,11 +34,17 @@ NSString *lowercaseStringPath = @keypath(NSString.new, lowercaseString);
  * path is valid at compile-time (causing a syntax error if not), and supports
  * refactoring, such that changing the name of the property will also update any
  * uses of \@keypath.
+ *
+ * When given an object and a separate key path, the result is a string
+ * literal. When given a single path, the receiver has to be removed from it,
+ * so the string is created once, the first time each use of the macro is
+ * evaluated, and reused afterward. In either case, evaluating \@keypath does
+ * not allocate memory.
  */
 #define keypath(...) \
     _Pragma("clang diagnostic push") \
     _Pragma("clang diagnostic ignored \"-Warc-repeated-use-of-weak\"") \
-    (NO).boolValue ? ((NSString * _Nonnull)nil) : ((NSString * _Nonnull)@(cStringKeypath(__VA_ARGS__))) \
+    (NO).boolValue ? ((NSString * _Nonnull)nil) : ((NSString * _Nonnull)objcKeypath(__VA_ARGS__)) \
     _Pragma("clang diagnostic pop") \
 
 #define cStringKeypath(...) \
@@ -51,6 +57,15 @@ NSString *lowercaseStringPath = @keypath(NSString.new, lowercaseString);
 #define keypath2(OBJ, PATH) \
     (((void)(NO && ((void)OBJ.PATH, NO)), # PATH))
 
+#define objcKeypath(...) \
+    metamacro_if_eq(1, metamacro_argcount(__VA_ARGS__))(objcKeypath1(__VA_ARGS__))(objcKeypath2(__VA_ARGS__))
+
+#define objcKeypath1(PATH) \
+    (((void)(NO && ((void)PATH, NO)), cachedKeypathSuffix(# PATH)))
+
+#define objcKeypath2(OBJ, PATH) \
+    (((void)(NO && ((void)OBJ.PATH, NO)), @"" # PATH))
+
 /**
  * \@collectionKeypath allows compile-time verification of key paths across collections NSArray/NSSet etc. Given a real object
  * receiver, collection object receiver and related keypaths:
@@ -65,13 +80,34 @@ NSString *lowercaseStringPath = @keypath(NSString.new, lowercaseString);
 
  * @endcode
  *
+ * When the collection property is named relative to an object type (as in the
+ * second example), the result is a string literal. Otherwise, the string is
+ * created once, the first time each use of the macro is evaluated, and reused
+ * afterward.
  */
 #define collectionKeypath(...) \
     metamacro_if_eq(3, metamacro_argcount(__VA_ARGS__))(collectionKeypath3(__VA_ARGS__))(collectionKeypath4(__VA_ARGS__))
 
 #define collectionKeypath3(PATH, COLLECTION_OBJECT, COLLECTION_PATH) \
-    (YES).boolValue ? (NSString * _Nonnull)@((const char * _Nonnull)[[NSString stringWithFormat:@"%s.%s", cStringKeypath(PATH), cStringKeypath(COLLECTION_OBJECT, COLLECTION_PATH)] UTF8String]) : (NSString * _Nonnull)nil
+    (YES).boolValue ? (NSString * _Nonnull)((void)(NO && ((void)PATH, (void)COLLECTION_OBJECT.COLLECTION_PATH, NO)), cachedKeypathSuffix(# PATH "." # COLLECTION_PATH)) : (NSString * _Nonnull)nil
 
 #define collectionKeypath4(OBJ, PATH, COLLECTION_OBJECT, COLLECTION_PATH) \
-    (YES).boolValue ? (NSString * _Nonnull)@((const char * _Nonnull)[[NSString stringWithFormat:@"%s.%s", cStringKeypath(OBJ, PATH), cStringKeypath(COLLECTION_OBJECT, COLLECTION_PATH)] UTF8String]) : (NSString * _Nonnull)nil
+    (YES).boolValue ? (NSString * _Nonnull)((void)(NO && ((void)OBJ.PATH, (void)COLLECTION_OBJECT.COLLECTION_PATH, NO)), @"" # PATH "." # COLLECTION_PATH) : (NSString * _Nonnull)nil
 
+/*
+ * Evaluates to an NSString containing everything after the first period in
+ * CSTRING, which must be a string literal. The string is created the first time
+ * this call site is evaluated, and then reused, since the suffix of a string
+ * literal can't be taken by the preprocessor.
+ */
+#define cachedKeypathSuffix(CSTRING) \
+    ({ \
+        static NSString *__extobjckeypath__ = nil; \
+        static dispatch_once_t __extobjckeypathonce__; \
+        dispatch_once(&__extobjckeypathonce__, ^{ \
+            const char *__extobjckeypathsuffix__ = strchr(CSTRING, '.'); \
+            NSCAssert(__extobjckeypathsuffix__, @"Provided key path is invalid."); \
+            __extobjckeypath__ = [[NSString alloc] initWithUTF8String:__extobjckeypathsuffix__ + 1]; \
+        }); \
+        __extobjckeypath__; \
+    })
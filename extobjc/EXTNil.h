@@ -20,6 +20,11 @@
  * compared for equality, to keep compatibility with code that expects or uses
  * \c NSNull.
  *
+ * The first message of any given selector sent to this object goes through
+ * the forwarding machinery, which installs a shared zero-returning
+ * implementation for that selector. Subsequent messages are dispatched
+ * normally, and cost about as much as any other message send.
+ *
  * @note Because this class does still behave like an object in some ways, it
  * will respond to certain \c NSObject protocol methods where an actually \c nil
  * object would not.
@@ -9,9 +9,288 @@
 
 #import "EXTNil.h"
 #import "EXTRuntimeExtensions.h"
+#import <string.h>
 
 static id singleton = nil;
 
+// set while +resolveInstanceMethod: is searching for a method signature, since
+// that search itself queries EXTNil (and would otherwise recurse forever)
+static __thread BOOL resolvingSelector = NO;
+
+/*
+ * The IMPs below are installed on EXTNil by +resolveInstanceMethod:, so that
+ * each selector only goes through the forwarding machinery once. Afterwards,
+ * messages to EXTNil are dispatched through the method cache like any other,
+ * and simply return zero.
+ *
+ * An IMP is only correct for a given selector if its return type is returned in
+ * the same way by the platform ABI. For scalars, that's just a matter of
+ * integer vs. floating-point registers. For structs, anything returned in
+ * memory only needs to match in size, and the same goes for structs returned in
+ * integer registers. Structs returned in floating-point registers (like CGPoint
+ * or CGRect) additionally need to have the same number of float or double
+ * members, up to the four allowed by any ABI. Anything else (unions, bitfields,
+ * long double, structs mixing integers and floats in registers) is left to
+ * -forwardInvocation:.
+ */
+static void ext_nilReturnVoid (id self, SEL _cmd) {
+}
+
+static long long ext_nilReturnInteger (id self, SEL _cmd) {
+    return 0;
+}
+
+static double ext_nilReturnFloating (id self, SEL _cmd) {
+    return 0;
+}
+
+#define ext_nilFloatingAggregateIMP_(TYPE, COUNT) \
+    typedef struct { TYPE values[COUNT]; } ext_nilAggregate_ ## TYPE ## COUNT; \
+    \
+    static ext_nilAggregate_ ## TYPE ## COUNT ext_nilReturnAggregate_ ## TYPE ## COUNT (id self, SEL _cmd) { \
+        return (ext_nilAggregate_ ## TYPE ## COUNT){ .values = { 0 } }; \
+    }
+
+#define ext_nilByteAggregateIMP_(SIZE) \
+    typedef struct { unsigned char bytes[SIZE]; } ext_nilAggregate_bytes ## SIZE; \
+    \
+    static ext_nilAggregate_bytes ## SIZE ext_nilReturnAggregate_bytes ## SIZE (id self, SEL _cmd) { \
+        return (ext_nilAggregate_bytes ## SIZE){ .bytes = { 0 } }; \
+    }
+
+ext_nilFloatingAggregateIMP_(float, 1)
+ext_nilFloatingAggregateIMP_(float, 2)
+ext_nilFloatingAggregateIMP_(float, 3)
+ext_nilFloatingAggregateIMP_(float, 4)
+ext_nilFloatingAggregateIMP_(double, 1)
+ext_nilFloatingAggregateIMP_(double, 2)
+ext_nilFloatingAggregateIMP_(double, 3)
+ext_nilFloatingAggregateIMP_(double, 4)
+
+// small structs (returned in registers on most platforms)
+ext_nilByteAggregateIMP_(1)
+ext_nilByteAggregateIMP_(2)
+ext_nilByteAggregateIMP_(3)
+ext_nilByteAggregateIMP_(4)
+ext_nilByteAggregateIMP_(5)
+ext_nilByteAggregateIMP_(6)
+ext_nilByteAggregateIMP_(7)
+ext_nilByteAggregateIMP_(8)
+ext_nilByteAggregateIMP_(9)
+ext_nilByteAggregateIMP_(10)
+ext_nilByteAggregateIMP_(11)
+ext_nilByteAggregateIMP_(12)
+ext_nilByteAggregateIMP_(13)
+ext_nilByteAggregateIMP_(14)
+ext_nilByteAggregateIMP_(15)
+ext_nilByteAggregateIMP_(16)
+
+// large structs (always returned in memory)
+ext_nilByteAggregateIMP_(20)
+ext_nilByteAggregateIMP_(24)
+ext_nilByteAggregateIMP_(28)
+ext_nilByteAggregateIMP_(32)
+ext_nilByteAggregateIMP_(40)
+ext_nilByteAggregateIMP_(48)
+ext_nilByteAggregateIMP_(56)
+ext_nilByteAggregateIMP_(64)
+ext_nilByteAggregateIMP_(96)
+ext_nilByteAggregateIMP_(128)
+
+static const IMP ext_nilFloatAggregateIMPs[] = {
+    [1] = (IMP)&ext_nilReturnAggregate_float1,
+    [2] = (IMP)&ext_nilReturnAggregate_float2,
+    [3] = (IMP)&ext_nilReturnAggregate_float3,
+    [4] = (IMP)&ext_nilReturnAggregate_float4
+};
+
+static const IMP ext_nilDoubleAggregateIMPs[] = {
+    [1] = (IMP)&ext_nilReturnAggregate_double1,
+    [2] = (IMP)&ext_nilReturnAggregate_double2,
+    [3] = (IMP)&ext_nilReturnAggregate_double3,
+    [4] = (IMP)&ext_nilReturnAggregate_double4
+};
+
+static const IMP ext_nilByteAggregateIMPs[] = {
+    [1] = (IMP)&ext_nilReturnAggregate_bytes1,
+    [2] = (IMP)&ext_nilReturnAggregate_bytes2,
+    [3] = (IMP)&ext_nilReturnAggregate_bytes3,
+    [4] = (IMP)&ext_nilReturnAggregate_bytes4,
+    [5] = (IMP)&ext_nilReturnAggregate_bytes5,
+    [6] = (IMP)&ext_nilReturnAggregate_bytes6,
+    [7] = (IMP)&ext_nilReturnAggregate_bytes7,
+    [8] = (IMP)&ext_nilReturnAggregate_bytes8,
+    [9] = (IMP)&ext_nilReturnAggregate_bytes9,
+    [10] = (IMP)&ext_nilReturnAggregate_bytes10,
+    [11] = (IMP)&ext_nilReturnAggregate_bytes11,
+    [12] = (IMP)&ext_nilReturnAggregate_bytes12,
+    [13] = (IMP)&ext_nilReturnAggregate_bytes13,
+    [14] = (IMP)&ext_nilReturnAggregate_bytes14,
+    [15] = (IMP)&ext_nilReturnAggregate_bytes15,
+    [16] = (IMP)&ext_nilReturnAggregate_bytes16,
+    [20] = (IMP)&ext_nilReturnAggregate_bytes20,
+    [24] = (IMP)&ext_nilReturnAggregate_bytes24,
+    [28] = (IMP)&ext_nilReturnAggregate_bytes28,
+    [32] = (IMP)&ext_nilReturnAggregate_bytes32,
+    [40] = (IMP)&ext_nilReturnAggregate_bytes40,
+    [48] = (IMP)&ext_nilReturnAggregate_bytes48,
+    [56] = (IMP)&ext_nilReturnAggregate_bytes56,
+    [64] = (IMP)&ext_nilReturnAggregate_bytes64,
+    [96] = (IMP)&ext_nilReturnAggregate_bytes96,
+    [128] = (IMP)&ext_nilReturnAggregate_bytes128
+};
+
+// the leaf members of a struct type, as counted by ext_nilScanAggregateMembers
+typedef struct {
+    NSUInteger integerCount;
+    NSUInteger floatCount;
+    NSUInteger doubleCount;
+    BOOL unsupported;
+} ext_nilAggregateMembers;
+
+static const char *ext_nilSkipTypeQualifiers (const char *type) {
+    while (*type && strchr("rnNoORV", *type))
+        ++type;
+
+    return type;
+}
+
+/**
+ * Adds the leaf members of the single type at \a type (multiplied by \a count,
+ * for arrays) to \a members. Returns a pointer just past the type.
+ */
+static const char *ext_nilScanAggregateMembers (const char *type, NSUInteger count, ext_nilAggregateMembers *members) {
+    type = ext_nilSkipTypeQualifiers(type);
+
+    switch (*type) {
+        case '{': {
+            // skip the struct name
+            const char *next = type + 1;
+            while (*next && *next != '=' && *next != '}')
+                ++next;
+
+            if (*next != '=') {
+                // opaque struct, no idea what's inside
+                members->unsupported = YES;
+                return next;
+            }
+
+            ++next;
+            while (*next != '}') {
+                if (!*next || members->unsupported) {
+                    members->unsupported = YES;
+                    return next;
+                }
+
+                next = ext_nilScanAggregateMembers(next, count, members);
+            }
+
+            return next + 1;
+        }
+
+        case '[': {
+            char *elementType = NULL;
+            unsigned long length = strtoul(type + 1, &elementType, 10);
+
+            const char *next = ext_nilScanAggregateMembers(elementType, count * length, members);
+            if (*next != ']') {
+                members->unsupported = YES;
+                return next;
+            }
+
+            return next + 1;
+        }
+
+        case 'f':
+            members->floatCount += count;
+            return type + 1;
+
+        case 'd':
+            members->doubleCount += count;
+            return type + 1;
+
+        case '\0':
+        case '(':
+        case 'b':
+        case 'D':
+        case 'j':
+        case '?':
+            members->unsupported = YES;
+            return type;
+
+        default:
+            members->integerCount += count;
+            return NSGetSizeAndAlignment(type, NULL, NULL);
+    }
+}
+
+/**
+ * Returns a zero-returning IMP which is ABI-compatible with a method returning
+ * \a type, or \c NULL if there is no such IMP.
+ */
+static IMP ext_nilIMPForReturnType (const char *type) {
+    type = ext_nilSkipTypeQualifiers(type);
+
+    switch (*type) {
+        case 'v':
+            return (IMP)&ext_nilReturnVoid;
+
+        case 'f':
+        case 'd':
+            return (IMP)&ext_nilReturnFloating;
+
+        case '{':
+            break;
+
+        case '(':
+        case 'b':
+        case 'D':
+        case 'j':
+        case '?':
+        case '\0':
+            return NULL;
+
+        default: {
+            NSUInteger size = 0;
+            NSGetSizeAndAlignment(type, &size, NULL);
+
+            if (size > sizeof(long long))
+                return NULL;
+
+            return (IMP)&ext_nilReturnInteger;
+        }
+    }
+
+    ext_nilAggregateMembers members = { 0, 0, 0, NO };
+    ext_nilScanAggregateMembers(type, 1, &members);
+    if (members.unsupported)
+        return NULL;
+
+    NSUInteger size = 0;
+    NSGetSizeAndAlignment(type, &size, NULL);
+
+    if (!members.integerCount) {
+        // structs consisting of a few floats or doubles may be returned in
+        // floating-point registers, and need to match exactly
+        if (!members.doubleCount && members.floatCount <= 4)
+            return ext_nilFloatAggregateIMPs[members.floatCount];
+
+        if (!members.floatCount && members.doubleCount <= 4)
+            return ext_nilDoubleAggregateIMPs[members.doubleCount];
+    }
+
+    if ((members.floatCount || members.doubleCount) && size <= 16) {
+        // any other mix of floating-point values is only safe when the struct
+        // is too large to be returned in registers anywhere
+        return NULL;
+    }
+
+    if (size >= sizeof(ext_nilByteAggregateIMPs) / sizeof(*ext_nilByteAggregateIMPs))
+        return NULL;
+
+    return ext_nilByteAggregateIMPs[size];
+}
+
 @implementation EXTNil
 + (void)initialize {
     if (self == [EXTNil class]) {
@@ -40,6 +319,33 @@ static id singleton = nil;
 
 #pragma mark Forwarding machinery
 
++ (BOOL)resolveInstanceMethod:(SEL)selector {
+    if (resolvingSelector)
+        return NO;
+
+    resolvingSelector = YES;
+    NSMethodSignature *signature = ext_globalMethodSignatureForSelector(selector);
+    resolvingSelector = NO;
+
+    if (!signature)
+        return NO;
+
+    IMP imp = ext_nilIMPForReturnType(signature.methodReturnType);
+    if (!imp) {
+        // fall back to -forwardInvocation:
+        return NO;
+    }
+
+    NSMutableString *types = [NSMutableString stringWithUTF8String:signature.methodReturnType];
+    for (NSUInteger i = 0;i < signature.numberOfArguments;++i) {
+        [types appendFormat:@"%s", [signature getArgumentTypeAtIndex:i]];
+    }
+
+    // this may fail if another thread got here first, which is fine
+    class_addMethod(self, selector, imp, types.UTF8String);
+    return YES;
+}
+
 - (void)forwardInvocation:(NSInvocation *)anInvocation {
     NSUInteger returnLength = [[anInvocation methodSignature] methodReturnLength];
     if (!returnLength) {
@@ -0,0 +1,116 @@
+//
+//  EXTObservation.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Describes a change to an observed property. This is only valid for the
+ * duration of the observer block which it is passed to.
+ */
+typedef struct {
+    /**
+     * The object whose property was set.
+     */
+    __unsafe_unretained id object;
+
+    /**
+     * The name of the property which was set.
+     */
+    __unsafe_unretained NSString *key;
+
+    /**
+     * The type encoding of the property, as it would be returned by \c
+     * \@encode().
+     */
+    const char *type;
+
+    /**
+     * Pointers to the values returned by the property's getter before and
+     * after it was set, which are of the property's type. Use
+     * #ext_propertyChangeOldValue and #ext_propertyChangeNewValue to read them.
+     */
+    const void *oldValue;
+    const void *newValue;
+} ext_propertyChange;
+
+/**
+ * A block which is invoked after an observed property has been set.
+ */
+typedef void (^ext_propertyObserver)(const ext_propertyChange *change);
+
+/**
+ * Returns the value of the property described by \a CHANGE from before it was
+ * set, as type \a TYPE, which must match the type of the property. For
+ * properties of object type, use <tt>__unsafe_unretained id</tt>.
+ */
+#define ext_propertyChangeOldValue(CHANGE, TYPE) \
+    (*(TYPE const *)(CHANGE)->oldValue)
+
+/**
+ * Returns the value of the property described by \a CHANGE from after it was
+ * set, as type \a TYPE, which must match the type of the property. For
+ * properties of object type, use <tt>__unsafe_unretained id</tt>.
+ */
+#define ext_propertyChangeNewValue(CHANGE, TYPE) \
+    (*(TYPE const *)(CHANGE)->newValue)
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Invokes \a observer every time the property named \a key is set on \a
+ * object, until #ext_removePropertyObserver is called with the returned token.
+ * Returns zero if the property could not be observed.
+ *
+ * This is a lightweight alternative to key-value observing. The first time a
+ * property is observed on any instance of a class, the setter of that property
+ * is replaced on the class with a version which notifies observers, and which
+ * costs a single atomic load while no instances of the class are being
+ * observed. Otherwise, the setter finds the object's observers in a table
+ * guarded by striped locks, so setters called on different objects rarely
+ * contend. Observers are kept in a compact array attached to each observed
+ * object, and are passed an #ext_propertyChange on the stack, so notifying
+ * them doesn't allocate any memory. Observed objects never change class.
+ *
+ * @code
+
+NSUInteger token = ext_addPropertyObserver(person, @keypath(person.age), ^(const ext_propertyChange *change){
+    NSLog(@"%@ is now %ld", change->object, (long)ext_propertyChangeNewValue(change, NSInteger));
+});
+
+person.age = 30;
+
+ext_removePropertyObserver(person, token);
+
+ * @endcode
+ *
+ * Observers are invoked synchronously on the thread which set the property,
+ * in the order they were added, every time the setter is invoked (even if the
+ * value didn't change). Setting the property from within an override of its
+ * setter in a subclass only notifies observers once.
+ *
+ * \a key must be the name of a property declared with \c \@property, whose
+ * type is an object or a number (not a structure or pointer). Unlike key-value
+ * observing, changes are only noticed when they're made through the setter,
+ * and key paths with more than one key are not supported.
+ *
+ * @note Observers are removed automatically when \a object is deallocated.
+ */
+NSUInteger ext_addPropertyObserver (id object, NSString *key, ext_propertyObserver observer);
+
+/**
+ * Removes the observer identified by \a token, which was returned by
+ * #ext_addPropertyObserver with the same \a object. Returns whether the
+ * observer was found.
+ */
+BOOL ext_removePropertyObserver (id object, NSUInteger token);
+
+#if defined(__cplusplus)
+}
+#endif
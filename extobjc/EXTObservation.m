@@ -0,0 +1,421 @@
+//
+//  EXTObservation.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTObservation.h"
+#import "EXTRuntimeExtensions.h"
+#import <objc/message.h>
+#import <objc/runtime.h>
+#import <os/lock.h>
+#import <stdatomic.h>
+#import <stdlib.h>
+#import <string.h>
+
+// the number of buckets in the table of observer lists, which must be a power
+// of two
+#define EXT_OBSERVATION_BUCKET_COUNT 4096
+
+// the number of locks guarding the buckets, so that setters called on
+// different objects rarely contend
+#define EXT_OBSERVATION_STRIPE_COUNT 64
+
+/*
+ * A setter which has been replaced on a class so that it notifies observers.
+ * These are never freed, since the replacement setter uses them for as long as
+ * the class exists.
+ */
+typedef struct ext_observedSetter {
+    struct ext_observedSetter *next;
+
+    __unsafe_unretained Class cls;
+
+    // retained for as long as the setter exists
+    __unsafe_unretained NSString *key;
+
+    SEL setter;
+    SEL getter;
+    IMP originalImplementation;
+    char *type;
+
+    // the number of observers of this property on instances of the class, which
+    // lets the replacement setter skip looking for observers when there are
+    // none
+    atomic_size_t observerCount;
+} ext_observedSetter;
+
+/*
+ * A setter which is in the process of notifying observers on the current
+ * thread.
+ */
+typedef struct ext_setterFrame {
+    __unsafe_unretained id object;
+    SEL setter;
+    struct ext_setterFrame *previous;
+} ext_setterFrame;
+
+/**
+ * An observer attached to an object.
+ */
+@interface EXTPropertyObserverEntry : NSObject {
+@public
+    NSString *_key;
+    NSUInteger _token;
+    ext_propertyObserver _block;
+    ext_observedSetter *_setter;
+}
+
+@end
+
+/**
+ * Associated with each observed object, to hold its observers.
+ */
+@interface EXTPropertyObserverList : NSObject {
+@public
+    // the address of the observed object
+    uintptr_t _object;
+
+    // the next list in the same bucket of ext_observerListBuckets
+    __unsafe_unretained EXTPropertyObserverList *_next;
+}
+
+// replaced (rather than mutated) whenever an observer is added or removed, so
+// that setters can enumerate it without locking
+@property (atomic, copy) NSArray *entries;
+
+@end
+
+typedef struct {
+    os_unfair_lock lock;
+} __attribute__((aligned(64))) ext_observerListStripe;
+
+// the key for an object's EXTPropertyObserverList
+static void *ext_propertyObserverListKey = &ext_propertyObserverListKey;
+
+// every EXTPropertyObserverList, chained by a hash of its object's address, so
+// that setters can find them without taking the runtime's lock for associated
+// objects. the lists are owned by their objects, and remove themselves from
+// here when they're deallocated.
+static __unsafe_unretained EXTPropertyObserverList *ext_observerListBuckets[EXT_OBSERVATION_BUCKET_COUNT];
+
+static ext_observerListStripe ext_observerListStripes[EXT_OBSERVATION_STRIPE_COUNT];
+
+// guards the list of observed setters, and the addition and removal of
+// observers
+static os_unfair_lock ext_observationLock = OS_UNFAIR_LOCK_INIT;
+
+// every setter which has been replaced
+static ext_observedSetter *ext_observedSetters = NULL;
+
+static _Atomic(NSUInteger) ext_nextObserverToken = 1;
+
+// the setters currently notifying observers on this thread, innermost first
+static __thread ext_setterFrame *ext_currentSetterFrame = NULL;
+
+@implementation EXTPropertyObserverEntry
+@end
+
+static size_t ext_observerListBucketForAddress (uintptr_t address) {
+    return ((address >> 4) ^ (address >> 16)) & (EXT_OBSERVATION_BUCKET_COUNT - 1);
+}
+
+static ext_observerListStripe *ext_observerListStripeForBucket (size_t bucket) {
+    return ext_observerListStripes + (bucket % EXT_OBSERVATION_STRIPE_COUNT);
+}
+
+/**
+ * Adds \a list to #ext_observerListBuckets, for the object at \a address.
+ */
+static void ext_insertObserverList (EXTPropertyObserverList *list, uintptr_t address) {
+    size_t bucket = ext_observerListBucketForAddress(address);
+    ext_observerListStripe *stripe = ext_observerListStripeForBucket(bucket);
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    list->_object = address;
+    list->_next = ext_observerListBuckets[bucket];
+    ext_observerListBuckets[bucket] = list;
+
+    os_unfair_lock_unlock(&stripe->lock);
+}
+
+/**
+ * Removes \a list from #ext_observerListBuckets, if it was added.
+ */
+static void ext_removeObserverList (__unsafe_unretained EXTPropertyObserverList *list) {
+    if (!list->_object)
+        return;
+
+    size_t bucket = ext_observerListBucketForAddress(list->_object);
+    ext_observerListStripe *stripe = ext_observerListStripeForBucket(bucket);
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    __unsafe_unretained EXTPropertyObserverList **link = &ext_observerListBuckets[bucket];
+    while (*link != list)
+        link = &(*link)->_next;
+
+    *link = list->_next;
+
+    os_unfair_lock_unlock(&stripe->lock);
+}
+
+@implementation EXTPropertyObserverList
+
+- (void)dealloc {
+    ext_removeObserverList(self);
+
+    for (EXTPropertyObserverEntry *entry in _entries) {
+        atomic_fetch_sub_explicit(&entry->_setter->observerCount, 1, memory_order_relaxed);
+    }
+}
+
+@end
+
+/**
+ * Returns whether \a setter is already notifying observers about \a object
+ * further up the stack, such as when a subclass's override of a setter invokes
+ * super's.
+ */
+static BOOL ext_isNotifyingObservers (id object, SEL setter) {
+    for (ext_setterFrame *frame = ext_currentSetterFrame;frame;frame = frame->previous) {
+        if (frame->object == object && frame->setter == setter)
+            return YES;
+    }
+
+    return NO;
+}
+
+/**
+ * Returns the observers attached to \a object, if any of them are observing \a
+ * key, or \c nil otherwise.
+ */
+static NSArray *ext_observerEntriesForKey (id object, NSString *key) {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    size_t bucket = ext_observerListBucketForAddress(address);
+    ext_observerListStripe *stripe = ext_observerListStripeForBucket(bucket);
+
+    NSArray *entries = nil;
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    // the list may be deallocating along with its object, so it mustn't be
+    // retained, but its entries remain valid until it's been removed
+    for (__unsafe_unretained EXTPropertyObserverList *list = ext_observerListBuckets[bucket];list;list = list->_next) {
+        if (list->_object == address) {
+            entries = list.entries;
+            break;
+        }
+    }
+
+    os_unfair_lock_unlock(&stripe->lock);
+
+    for (EXTPropertyObserverEntry *entry in entries) {
+        if (entry->_key == key)
+            return entries;
+    }
+
+    return nil;
+}
+
+static void ext_notifyObservers (NSArray *entries, const ext_propertyChange *change) {
+    for (EXTPropertyObserverEntry *entry in entries) {
+        if (entry->_key == change->key)
+            entry->_block(change);
+    }
+}
+
+/*
+ * Creates a heap block which replaces a setter for a property of type TYPE.
+ *
+ * Unless there are observers for the property on this object, the original
+ * setter is invoked immediately. Otherwise, the getter is invoked before and
+ * after the original setter, to get the old and new values for the observers.
+ */
+#define ext_observedSetterBlock(SETTER, TYPE) \
+    [^(id self, TYPE value){ \
+        NSArray *entries = nil; \
+        \
+        if (atomic_load_explicit(&(SETTER)->observerCount, memory_order_relaxed) > 0 && !ext_isNotifyingObservers(self, (SETTER)->setter)) \
+            entries = ext_observerEntriesForKey(self, (SETTER)->key); \
+        \
+        if (!entries) { \
+            ((void (*)(id, SEL, TYPE))(SETTER)->originalImplementation)(self, (SETTER)->setter, value); \
+            return; \
+        } \
+        \
+        TYPE oldValue = ((TYPE (*)(id, SEL))objc_msgSend)(self, (SETTER)->getter); \
+        \
+        ext_setterFrame frame = { self, (SETTER)->setter, ext_currentSetterFrame }; \
+        ext_currentSetterFrame = &frame; \
+        \
+        ((void (*)(id, SEL, TYPE))(SETTER)->originalImplementation)(self, (SETTER)->setter, value); \
+        \
+        ext_currentSetterFrame = frame.previous; \
+        \
+        TYPE newValue = ((TYPE (*)(id, SEL))objc_msgSend)(self, (SETTER)->getter); \
+        \
+        ext_propertyChange change = { self, (SETTER)->key, (SETTER)->type, &oldValue, &newValue }; \
+        ext_notifyObservers(entries, &change); \
+    } copy]
+
+/**
+ * Returns a block to replace \a setter, or \c nil if its type is unsupported.
+ */
+static id ext_observedSetterBlockForSetter (ext_observedSetter *setter) {
+    const char *type = setter->type;
+
+    // skip type qualifiers, like const
+    while (*type && strchr("rnNoORV", *type))
+        ++type;
+
+    switch (*type) {
+        case '@':
+        case '#': return ext_observedSetterBlock(setter, id);
+        case 'c': return ext_observedSetterBlock(setter, char);
+        case 'C': return ext_observedSetterBlock(setter, unsigned char);
+        case 's': return ext_observedSetterBlock(setter, short);
+        case 'S': return ext_observedSetterBlock(setter, unsigned short);
+        case 'i': return ext_observedSetterBlock(setter, int);
+        case 'I': return ext_observedSetterBlock(setter, unsigned int);
+        case 'l': return ext_observedSetterBlock(setter, long);
+        case 'L': return ext_observedSetterBlock(setter, unsigned long);
+        case 'q': return ext_observedSetterBlock(setter, long long);
+        case 'Q': return ext_observedSetterBlock(setter, unsigned long long);
+        case 'f': return ext_observedSetterBlock(setter, float);
+        case 'd': return ext_observedSetterBlock(setter, double);
+        case 'B': return ext_observedSetterBlock(setter, _Bool);
+        default: return nil;
+    }
+}
+
+/**
+ * Returns the observed setter for the property named \a key on \a cls,
+ * replacing the setter if it hasn't been already. Returns \c NULL if the
+ * property can't be observed.
+ *
+ * This must be called with #ext_observationLock held.
+ */
+static ext_observedSetter *ext_observedSetterForProperty (Class cls, NSString *key) {
+    for (ext_observedSetter *setter = ext_observedSetters;setter;setter = setter->next) {
+        if (setter->cls == cls && [setter->key isEqualToString:key])
+            return setter;
+    }
+
+    objc_property_t property = class_getProperty(cls, key.UTF8String);
+    if (!property)
+        return NULL;
+
+    ext_propertyAttributes *attributes = ext_copyPropertyAttributes(property);
+    if (!attributes)
+        return NULL;
+
+    Method setterMethod = NULL;
+    if (!attributes->readonly)
+        setterMethod = class_getInstanceMethod(cls, attributes->setter);
+
+    if (!setterMethod) {
+        free(attributes);
+        return NULL;
+    }
+
+    ext_observedSetter *setter = calloc(1, sizeof(*setter));
+    if (!setter) {
+        free(attributes);
+        return NULL;
+    }
+
+    setter->cls = cls;
+    setter->setter = attributes->setter;
+    setter->getter = attributes->getter;
+    setter->type = strdup(attributes->type);
+    free(attributes);
+
+    id block = (setter->type ? ext_observedSetterBlockForSetter(setter) : nil);
+    if (!block) {
+        free(setter->type);
+        free(setter);
+        return NULL;
+    }
+
+    setter->key = (__bridge NSString *)CFBridgingRetain([key copy]);
+
+    // class_replaceMethod() adds the method if it's only inherited, so that
+    // the replacement only affects this class and its subclasses
+    setter->originalImplementation = method_getImplementation(setterMethod);
+    class_replaceMethod(cls, setter->setter, imp_implementationWithBlock(block), method_getTypeEncoding(setterMethod));
+
+    setter->next = ext_observedSetters;
+    ext_observedSetters = setter;
+
+    return setter;
+}
+
+NSUInteger ext_addPropertyObserver (id object, NSString *key, ext_propertyObserver observer) {
+    NSCParameterAssert(object != nil);
+    NSCParameterAssert(key != nil);
+    NSCParameterAssert(observer != nil);
+
+    // use the class that the object claims to be, so that setters are never
+    // replaced on a subclass created by key-value observing
+    Class cls = [object class];
+
+    os_unfair_lock_lock(&ext_observationLock);
+
+    ext_observedSetter *setter = ext_observedSetterForProperty(cls, key);
+    if (!setter) {
+        os_unfair_lock_unlock(&ext_observationLock);
+
+        NSCAssert(NO, @"Could not observe property \"%@\" on %@", key, cls);
+        return 0;
+    }
+
+    EXTPropertyObserverEntry *entry = [[EXTPropertyObserverEntry alloc] init];
+    entry->_key = setter->key;
+    entry->_token = atomic_fetch_add_explicit(&ext_nextObserverToken, 1, memory_order_relaxed);
+    entry->_block = [observer copy];
+    entry->_setter = setter;
+
+    EXTPropertyObserverList *list = objc_getAssociatedObject(object, ext_propertyObserverListKey);
+    if (!list) {
+        list = [[EXTPropertyObserverList alloc] init];
+        objc_setAssociatedObject(object, ext_propertyObserverListKey, list, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        ext_insertObserverList(list, (uintptr_t)(__bridge void *)object);
+    }
+
+    list.entries = (list.entries ? [list.entries arrayByAddingObject:entry] : [NSArray arrayWithObject:entry]);
+    atomic_fetch_add_explicit(&setter->observerCount, 1, memory_order_relaxed);
+
+    os_unfair_lock_unlock(&ext_observationLock);
+    return entry->_token;
+}
+
+BOOL ext_removePropertyObserver (id object, NSUInteger token) {
+    NSCParameterAssert(object != nil);
+
+    os_unfair_lock_lock(&ext_observationLock);
+
+    EXTPropertyObserverList *list = objc_getAssociatedObject(object, ext_propertyObserverListKey);
+    NSArray *entries = list.entries;
+
+    for (NSUInteger i = 0;i < entries.count;++i) {
+        EXTPropertyObserverEntry *entry = [entries objectAtIndex:i];
+        if (entry->_token != token)
+            continue;
+
+        NSMutableArray *remainingEntries = [entries mutableCopy];
+        [remainingEntries removeObjectAtIndex:i];
+        list.entries = remainingEntries;
+
+        atomic_fetch_sub_explicit(&entry->_setter->observerCount, 1, memory_order_relaxed);
+
+        os_unfair_lock_unlock(&ext_observationLock);
+        return YES;
+    }
+
+    os_unfair_lock_unlock(&ext_observationLock);
+    return NO;
+}
@@ -32,6 +32,24 @@
     ext_keywordify \
     __strong ext_cleanupBlock_t metamacro_concat(ext_exitBlock_, __LINE__) __attribute__((cleanup(ext_executeCleanupBlock), unused)) = ^
 
+/**
+ * Like \@onExit, but guaranteed not to allocate any memory, which makes it
+ * suitable for hot loops and other performance-sensitive code.
+ *
+ * In Objective-C, the cleanup block is never copied to the heap, and is invoked
+ * inline at the end of the scope. This means that \c __block variables
+ * referenced from it stay on the stack as well. In Objective-C++, the cleanup
+ * code is instead placed in a lambda (capturing by reference) that is invoked
+ * by an RAII guard object, which the compiler can optimize away entirely.
+ *
+ * @warning Unlike \@onExit, the cleanup code must not be captured by or
+ * escape into any other block, since it is only valid until the end of the
+ * current scope.
+ */
+#define onExitInline \
+    ext_keywordify \
+    ext_onExitInline_
+
 /**
  * Creates \c __weak shadow variables for each of the variables provided as
  * arguments, which can later be made strong again with #strongify.
@@ -98,6 +116,42 @@ extern "C" {
 }
 #endif
 
+static inline void ext_executeInlineCleanupBlock (__unsafe_unretained ext_cleanupBlock_t *block) {
+    (*block)();
+}
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+    struct ext_scopeGuardMaker {};
+
+    template <typename F>
+    class ext_scopeGuard {
+    public:
+        ext_scopeGuard (F &&cleanup) : cleanup_(static_cast<F &&>(cleanup)) {}
+        ~ext_scopeGuard () { cleanup_(); }
+
+        ext_scopeGuard (const ext_scopeGuard &) = delete;
+        ext_scopeGuard &operator= (const ext_scopeGuard &) = delete;
+
+    private:
+        F cleanup_;
+    };
+
+    // returned by copy-list-initialization, and bound to an rvalue reference
+    // by #onExitInline, so that the guard is never copied or moved
+    template <typename F>
+    inline ext_scopeGuard<F> operator+ (ext_scopeGuardMaker, F &&cleanup) {
+        return { static_cast<F &&>(cleanup) };
+    }
+
+    #define ext_onExitInline_ \
+        auto &&metamacro_concat(ext_exitGuard_, __LINE__) __attribute__((unused)) = ext_scopeGuardMaker() + [&]()
+#else
+    // the block literal lives on the stack until the end of the enclosing
+    // scope, and is never retained (and thus never copied)
+    #define ext_onExitInline_ \
+        __unsafe_unretained ext_cleanupBlock_t metamacro_concat(ext_exitBlock_, __LINE__) __attribute__((cleanup(ext_executeInlineCleanupBlock), unused)) = ^
+#endif
+
 #define ext_weakify_(INDEX, CONTEXT, VAR) \
     CONTEXT __typeof__(VAR) metamacro_concat(VAR, _weak_) = (VAR);
 
@@ -107,16 +161,13 @@ extern "C" {
 // Details about the choice of backing keyword:
 //
 // The use of @try/@catch/@finally can cause the compiler to suppress
-// return-type warnings.
+// return-type warnings, and emits exception handling metadata for every use.
 // The use of @autoreleasepool {} is not optimized away by the compiler,
 // resulting in superfluous creation of autorelease pools.
 //
-// Since neither option is perfect, and with no other alternatives, the
-// compromise is to use @autorelease in DEBUG builds to maintain compiler
-// analysis, and to use @try/@catch otherwise to avoid insertion of unnecessary
-// autorelease pools.
-#if defined(DEBUG) && !defined(NDEBUG)
-#define ext_keywordify autoreleasepool {}
-#else
-#define ext_keywordify try {} @catch (...) {}
-#endif
+// Instead, we use @encode, which evaluates to a string literal at compile
+// time. Indexing into it yields a constant character, and using that as the
+// condition of a ternary whose branches are both void avoids any unused value
+// warnings. The whole statement is constant-folded away, even without
+// optimization, so it generates no code and doesn't affect compiler analysis.
+#define ext_keywordify encode(void)[0] ? (void)0 : (void)0;
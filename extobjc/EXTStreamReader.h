@@ -0,0 +1,121 @@
+//
+//  EXTStreamReader.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * A range of bytes which is owned by something else.
+ */
+typedef struct {
+    const char *bytes;
+    size_t length;
+} ext_slice;
+
+/**
+ * A coroutine which produces slices from an #ext_streamReader. Each invocation
+ * stores the next slice into \a slice and returns \c YES, or returns \c NO once
+ * the stream has been exhausted.
+ */
+typedef BOOL (^ext_sliceGenerator)(ext_slice *slice);
+
+/**
+ * Reads a file descriptor or memory-mapped file, for parsing by coroutines
+ * created from it.
+ *
+ * Coroutines created with #ext_streamReaderLines, #ext_streamReaderTokens,
+ * and #ext_streamReaderRecords produce slices which point directly into the
+ * reader's buffer (or the mapped file), so reading a stream never allocates
+ * memory for each item, and the data is never copied more than once.
+ *
+ * @code
+
+ext_streamReader *reader = ext_streamReaderCreateWithMappedFile("/var/log/system.log");
+ext_sliceGenerator lines = ext_streamReaderLines(reader);
+
+ext_slice line;
+while (lines(&line)) {
+    fwrite(line.bytes, 1, line.length, stdout);
+    putchar('\n');
+}
+
+ext_streamReaderDestroy(reader);
+
+ * @endcode
+ *
+ * All of the coroutines created from a reader share its position in the
+ * stream, so they can be used one after another, such as to read a header line
+ * followed by a series of fixed-size records. Only one of them should be used
+ * at a time.
+ *
+ * @warning Slices produced from a file descriptor are only valid until the
+ * next time any coroutine created from the same reader is invoked, since the
+ * buffer is reused. Slices produced from a mapped file remain valid until the
+ * reader is destroyed.
+ */
+typedef struct ext_streamReader ext_streamReader;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Creates a reader which reads from \a fd into a buffer of \a bufferSize bytes,
+ * or a reasonable default if \a bufferSize is zero. The buffer grows as needed
+ * to hold any single item being read. \a fd is not closed when the reader is
+ * destroyed.
+ *
+ * Returns \c NULL if memory could not be allocated.
+ */
+ext_streamReader *ext_streamReaderCreateWithDescriptor (int fd, size_t bufferSize);
+
+/**
+ * Creates a reader which maps the file at \a path into memory, and tells the
+ * kernel that it will be read sequentially, so that it can read ahead
+ * aggressively and drop pages once they have been read.
+ *
+ * Returns \c NULL and sets \c errno if the file could not be opened or mapped.
+ */
+ext_streamReader *ext_streamReaderCreateWithMappedFile (const char *path);
+
+/**
+ * Frees \a reader, unmapping its file if it has one. Any coroutines created
+ * from \a reader must not be invoked afterward.
+ */
+void ext_streamReaderDestroy (ext_streamReader *reader);
+
+/**
+ * Returns the \c errno value from the first failed read from \a reader, or
+ * zero if no reads have failed. Once a read fails, the reader treats the
+ * stream as if it ended at that point.
+ */
+int ext_streamReaderError (ext_streamReader *reader);
+
+/**
+ * Returns a coroutine which produces each line from \a reader, without the
+ * trailing line feed (or carriage return and line feed). The last line does
+ * not need to end with a line feed.
+ */
+ext_sliceGenerator ext_streamReaderLines (ext_streamReader *reader);
+
+/**
+ * Returns a coroutine which produces each run of bytes from \a reader between
+ * occurrences of \a delimiter, which is not included. Consecutive delimiters
+ * produce empty slices.
+ */
+ext_sliceGenerator ext_streamReaderTokens (ext_streamReader *reader, char delimiter);
+
+/**
+ * Returns a coroutine which produces consecutive \a recordSize byte records
+ * from \a reader. If the stream does not end on a record boundary, the last
+ * record produced is shorter than \a recordSize.
+ */
+ext_sliceGenerator ext_streamReaderRecords (ext_streamReader *reader, size_t recordSize);
+
+#if defined(__cplusplus)
+}
+#endif
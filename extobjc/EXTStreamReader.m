@@ -0,0 +1,265 @@
+//
+//  EXTStreamReader.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTStreamReader.h"
+#import "EXTCoroutine.h"
+#import <errno.h>
+#import <fcntl.h>
+#import <stdlib.h>
+#import <string.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+// the default size of the buffer used to read from a file descriptor
+static const size_t ext_streamReaderDefaultBufferSize = 64 * 1024;
+
+struct ext_streamReader {
+    // the file descriptor being read from, or -1 for a mapped file
+    int fd;
+
+    // the buffer being read into, or the mapped file
+    char *buffer;
+    size_t capacity;
+
+    // the range of the buffer which has been read but not yet consumed
+    size_t start;
+    size_t end;
+
+    // whether there is nothing more to read into the buffer
+    BOOL finished;
+    int error;
+
+    // the mapped file, if there is one
+    void *mapping;
+    size_t mappingLength;
+};
+
+/**
+ * Reads more data from the stream into the buffer, making room for it if
+ * necessary by discarding consumed data or growing the buffer. Slices
+ * previously produced from the buffer are invalidated.
+ *
+ * Returns whether any data was read.
+ */
+static BOOL ext_streamReaderFill (ext_streamReader *reader) {
+    if (reader->finished)
+        return NO;
+
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+
+    if (reader->end == reader->capacity) {
+        // a single item doesn't fit in the buffer
+        size_t capacity = reader->capacity * 2;
+
+        char *buffer = realloc(reader->buffer, capacity);
+        if (!buffer) {
+            reader->error = ENOMEM;
+            reader->finished = YES;
+            return NO;
+        }
+
+        reader->buffer = buffer;
+        reader->capacity = capacity;
+    }
+
+    for (;;) {
+        ssize_t bytesRead = read(reader->fd, reader->buffer + reader->end, reader->capacity - reader->end);
+
+        if (bytesRead > 0) {
+            reader->end += (size_t)bytesRead;
+            return YES;
+        }
+
+        if (bytesRead < 0) {
+            if (errno == EINTR)
+                continue;
+
+            reader->error = errno;
+        }
+
+        reader->finished = YES;
+        return NO;
+    }
+}
+
+ext_streamReader *ext_streamReaderCreateWithDescriptor (int fd, size_t bufferSize) {
+    ext_streamReader *reader = calloc(1, sizeof(*reader));
+    if (!reader)
+        return NULL;
+
+    reader->fd = fd;
+    reader->capacity = (bufferSize ? bufferSize : ext_streamReaderDefaultBufferSize);
+
+    reader->buffer = malloc(reader->capacity);
+    if (!reader->buffer) {
+        free(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+ext_streamReader *ext_streamReaderCreateWithMappedFile (const char *path) {
+    NSCParameterAssert(path != NULL);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat fileStatus;
+    if (fstat(fd, &fileStatus) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return NULL;
+    }
+
+    size_t length = (size_t)fileStatus.st_size;
+    void *mapping = NULL;
+
+    // empty files can't be mapped, but don't need to be
+    if (length > 0) {
+        mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            return NULL;
+        }
+
+        // this is only a hint, so failure doesn't matter
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+
+    // the mapping stays valid after the file is closed
+    close(fd);
+
+    ext_streamReader *reader = calloc(1, sizeof(*reader));
+    if (!reader) {
+        if (mapping)
+            munmap(mapping, length);
+
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    reader->fd = -1;
+    reader->buffer = mapping;
+    reader->capacity = length;
+    reader->end = length;
+    reader->finished = YES;
+    reader->mapping = mapping;
+    reader->mappingLength = length;
+
+    return reader;
+}
+
+void ext_streamReaderDestroy (ext_streamReader *reader) {
+    if (!reader)
+        return;
+
+    if (reader->mapping)
+        munmap(reader->mapping, reader->mappingLength);
+    else
+        free(reader->buffer);
+
+    free(reader);
+}
+
+int ext_streamReaderError (ext_streamReader *reader) {
+    NSCParameterAssert(reader != NULL);
+    return reader->error;
+}
+
+static ext_sliceGenerator ext_streamReaderDelimited (ext_streamReader *reader, char delimiter, BOOL trimCarriageReturns) {
+    NSCParameterAssert(reader != NULL);
+
+    // how many bytes after the start of the buffer have already been searched
+    // for the delimiter, so that they aren't searched again after a refill
+    __block size_t searched = 0;
+
+    return coroutine(ext_slice *slice)({
+        for (;;) {
+            if (reader->end - reader->start > searched) {
+                slice->bytes = reader->buffer + reader->start;
+
+                const char *delimiterPosition = memchr(slice->bytes + searched, delimiter, reader->end - reader->start - searched);
+                if (delimiterPosition) {
+                    slice->length = (size_t)(delimiterPosition - slice->bytes);
+                    reader->start += slice->length + 1;
+                    searched = 0;
+
+                    if (trimCarriageReturns && slice->length > 0 && slice->bytes[slice->length - 1] == '\r')
+                        --slice->length;
+
+                    yield YES;
+                    continue;
+                }
+
+                searched = reader->end - reader->start;
+            }
+
+            if (ext_streamReaderFill(reader))
+                continue;
+
+            if (reader->start == reader->end)
+                break;
+
+            // the stream ended without a final delimiter
+            slice->bytes = reader->buffer + reader->start;
+            slice->length = reader->end - reader->start;
+            reader->start = reader->end;
+            searched = 0;
+
+            if (trimCarriageReturns && slice->bytes[slice->length - 1] == '\r')
+                --slice->length;
+
+            yield YES;
+        }
+
+        yield NO;
+    });
+}
+
+ext_sliceGenerator ext_streamReaderLines (ext_streamReader *reader) {
+    return ext_streamReaderDelimited(reader, '\n', YES);
+}
+
+ext_sliceGenerator ext_streamReaderTokens (ext_streamReader *reader, char delimiter) {
+    return ext_streamReaderDelimited(reader, delimiter, NO);
+}
+
+ext_sliceGenerator ext_streamReaderRecords (ext_streamReader *reader, size_t recordSize) {
+    NSCParameterAssert(reader != NULL);
+    NSCParameterAssert(recordSize > 0);
+
+    return coroutine(ext_slice *slice)({
+        for (;;) {
+            while (reader->end - reader->start < recordSize) {
+                if (!ext_streamReaderFill(reader))
+                    break;
+            }
+
+            slice->bytes = reader->buffer + reader->start;
+            slice->length = MIN(reader->end - reader->start, recordSize);
+
+            if (slice->length == 0)
+                break;
+
+            reader->start += slice->length;
+            yield YES;
+        }
+
+        yield NO;
+    });
+}
@@ -11,18 +11,44 @@
 #import <objc/runtime.h>
 
 /**
- * \@synthesizeAssociation synthesizes a property for a class using associated
- * objects. This is primarily useful for adding properties to a class within
- * a category.
+ * \@synthesizeAssociation synthesizes a property for a class using storage
+ * attached to each instance, like associated objects. This is primarily useful
+ * for adding properties to a class within a category.
  *
  * PROPERTY must have been declared with \@property in the interface of the
- * specified class (or a category upon it), and must be of object type.
+ * specified class (or a category upon it), and must not be \c weak. Properties
+ * of object type are retained or copied according to their declaration.
+ * Properties of any other type, like numbers and structures, are stored
+ * directly, without boxing them into \c NSNumber or \c NSValue objects, and
+ * are zero until they're first set.
+ *
+ * Rather than going through \c objc_setAssociatedObject(), which takes a single
+ * lock shared by every object in the process, the properties synthesized for
+ * a class in the same source file are laid out together, and each object gets
+ * a block of storage for them the first time one of them is set. Every access
+ * locks one of many tables of objects, finds the object's storage for the
+ * property's group, and reads or writes at a fixed offset. Threads working with
+ * different objects rarely contend for the same lock.
+ *
+ * @code
+
+@interface NSView (Badges)
+@property (nonatomic, copy) NSString *badgeTitle;
+@property (nonatomic, assign) NSInteger badgeCount;
+@property (nonatomic, assign) NSPoint badgeOrigin;
+@end
+
+@implementation NSView (Badges)
+@synthesizeAssociation(NSView, badgeTitle);
+@synthesizeAssociation(NSView, badgeCount);
+@synthesizeAssociation(NSView, badgeOrigin);
+@end
+
+ * @endcode
  */
 #define synthesizeAssociation(CLASS, PROPERTY) \
 	dynamic PROPERTY; \
 	\
-	static void *ext_uniqueKey_ ## CLASS ## _ ## PROPERTY = &ext_uniqueKey_ ## CLASS ## _ ## PROPERTY; \
-	\
 	__attribute__((constructor)) \
 	static void ext_ ## CLASS ## _ ## PROPERTY ## _synthesize (void) { \
 		Class cls = objc_getClass(# CLASS); \
@@ -37,14 +63,16 @@
 		\
 		NSCAssert(!attributes->weak, @"@synthesizeAssociation does not support weak properties (%@.%s)", cls, # PROPERTY); \
 		\
-		objc_AssociationPolicy policy = OBJC_ASSOCIATION_ASSIGN; \
+		BOOL retained = NO; \
+		BOOL copied = NO; \
 		switch (attributes->memoryManagementPolicy) { \
 			case ext_propertyMemoryManagementPolicyRetain: \
-				policy = attributes->nonatomic ? OBJC_ASSOCIATION_RETAIN_NONATOMIC : OBJC_ASSOCIATION_RETAIN; \
+				retained = YES; \
 				break; \
 			\
 			case ext_propertyMemoryManagementPolicyCopy: \
-				policy = attributes->nonatomic ? OBJC_ASSOCIATION_COPY_NONATOMIC : OBJC_ASSOCIATION_COPY; \
+				retained = YES; \
+				copied = YES; \
 				break; \
 			\
 			case ext_propertyMemoryManagementPolicyAssign: \
@@ -54,21 +82,128 @@
 				NSCAssert(NO, @"Unrecognized property memory management policy %i", (int)attributes->memoryManagementPolicy); \
 		} \
 		\
-		id getter = ^(id self){ \
-			return objc_getAssociatedObject(self, ext_uniqueKey_ ## CLASS ## _ ## PROPERTY); \
-		}; \
+		ext_associationGroup *group = ext_associationGroupForClass(cls, __FILE__); \
+		if (!group) { \
+			NSLog(@"*** Could not allocate memory for the storage of %@.%s", cls, # PROPERTY); \
+			free(attributes); \
+			return; \
+		} \
+		\
+		/* the declared type of the property, which is only used if it isn't an
+		 * object */ \
+		typedef __typeof__(((CLASS *)nil).PROPERTY) ext_propertyType; \
+		\
+		id getter = nil; \
+		id setter = nil; \
+		const char *getterTypes = NULL; \
+		const char *setterTypes = NULL; \
+		\
+		if (attributes->type[0] == '@' || attributes->type[0] == '#') { \
+			size_t offset = ext_addAssociationSlot(group, sizeof(id), __alignof__(id), retained); \
+			\
+			getter = ^(id self){ \
+				return ext_getAssociationSlotObject(self, group, offset); \
+			}; \
+			\
+			setter = ^(id self, id value){ \
+				ext_setAssociationSlotObject(self, group, offset, (copied ? [value copy] : value), retained); \
+			}; \
+			\
+			getterTypes = "@@:"; \
+			setterTypes = "v@:@"; \
+		} else { \
+			size_t offset = ext_addAssociationSlot(group, sizeof(ext_propertyType), __alignof__(ext_propertyType), NO); \
+			\
+			getter = ^(id self){ \
+				ext_propertyType value; \
+				ext_getAssociationSlotBytes(self, group, offset, &value, sizeof(value)); \
+				return value; \
+			}; \
+			\
+			setter = ^(id self, ext_propertyType value){ \
+				ext_setAssociationSlotBytes(self, group, offset, &value, sizeof(value)); \
+			}; \
+			\
+			/* never freed, since the runtime may refer to them for as long as
+			 * the methods exist */ \
+			getterTypes = ext_copyAssociationMethodTypes(attributes->type, "", "@:"); \
+			setterTypes = ext_copyAssociationMethodTypes("v@:", attributes->type, ""); \
+		} \
 		\
-		id setter = ^(id self, id value){ \
-			objc_setAssociatedObject(self, ext_uniqueKey_ ## CLASS ## _ ## PROPERTY, value, policy); \
-		}; \
+		if (!getterTypes || !setterTypes) { \
+			NSLog(@"*** Could not allocate memory for the methods of %@.%s", cls, # PROPERTY); \
+			free(attributes); \
+			return; \
+		} \
 		\
-		if (!class_addMethod(cls, attributes->getter, imp_implementationWithBlock(getter), "@@:")) { \
+		if (!class_addMethod(cls, attributes->getter, imp_implementationWithBlock(getter), getterTypes)) { \
 			NSCAssert(NO, @"Could not add getter %s for property %@.%s", sel_getName(attributes->getter), cls, # PROPERTY); \
 		} \
 		\
-		if (!class_addMethod(cls, attributes->setter, imp_implementationWithBlock(setter), "v@:@")) { \
+		if (!class_addMethod(cls, attributes->setter, imp_implementationWithBlock(setter), setterTypes)) { \
 			NSCAssert(NO, @"Could not add setter %s for property %@.%s", sel_getName(attributes->setter), cls, # PROPERTY); \
 		} \
 		\
 		free(attributes); \
 	}
+
+/*** implementation details follow ***/
+
+/**
+ * A set of associated properties which are stored together.
+ */
+typedef struct ext_associationGroup ext_associationGroup;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Returns the group for properties of \a cls synthesized in \a file, creating
+ * it if necessary, or \c NULL if memory could not be allocated.
+ */
+ext_associationGroup *ext_associationGroupForClass (Class cls, const char *file);
+
+/**
+ * Reserves \a size bytes, aligned to \a alignment, in the storage of every
+ * object for \a group, and returns their offset. If \a retained is \c YES,
+ * the storage holds an object, which is released when its owner is
+ * deallocated.
+ */
+size_t ext_addAssociationSlot (ext_associationGroup *group, size_t size, size_t alignment, BOOL retained);
+
+/**
+ * Returns the object stored at \a offset (returned by #ext_addAssociationSlot)
+ * for \a object in \a group, or \c nil if none has been stored.
+ */
+id ext_getAssociationSlotObject (id object, ext_associationGroup *group, size_t offset);
+
+/**
+ * Stores \a value at \a offset (returned by #ext_addAssociationSlot) for \a
+ * object in \a group, retaining it if \a retained is \c YES, and releasing
+ * the previous value if so.
+ */
+void ext_setAssociationSlotObject (id object, ext_associationGroup *group, size_t offset, id value, BOOL retained);
+
+/**
+ * Reads \a size bytes stored at \a offset (returned by #ext_addAssociationSlot)
+ * for \a object in \a group into \a value, which are zero if nothing has been
+ * stored.
+ */
+void ext_getAssociationSlotBytes (id object, ext_associationGroup *group, size_t offset, void *value, size_t size);
+
+/**
+ * Stores \a size bytes from \a value at \a offset (returned by
+ * #ext_addAssociationSlot) for \a object in \a group.
+ */
+void ext_setAssociationSlotBytes (id object, ext_associationGroup *group, size_t offset, const void *value, size_t size);
+
+/**
+ * Returns a new string made of \a first, \a second, and \a third, for the
+ * type encoding of a method, or \c NULL if memory could not be allocated.
+ */
+char *ext_copyAssociationMethodTypes (const char *first, const char *second, const char *third);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,513 @@
+//
+//  EXTSynthesize.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTSynthesize.h"
+#import <os/lock.h>
+#import <stdatomic.h>
+#import <stdlib.h>
+#import <string.h>
+
+// the number of independently locked tables that objects are spread across,
+// so that threads working with different objects rarely contend
+#define EXT_ASSOCIATION_STRIPE_COUNT 64
+
+// the largest alignment that an associated property can require
+#define EXT_ASSOCIATION_MAXIMUM_ALIGNMENT 16
+
+/*
+ * The offsets of every slot in a group which holds a retained object, so that
+ * they can be released along with the object that owns them. A new list
+ * replaces this one whenever a property is added to the group, and the old one
+ * is never freed, since an object could be deallocated on another thread while
+ * it's being read.
+ */
+typedef struct {
+    size_t count;
+    size_t offsets[];
+} ext_retainedAssociationOffsets;
+
+/*
+ * The properties synthesized for one class in one source file, which are
+ * stored together. Groups are never freed, since the synthesized methods refer
+ * to them for as long as the class exists.
+ */
+struct ext_associationGroup {
+    struct ext_associationGroup *next;
+
+    __unsafe_unretained Class cls;
+    char *file;
+
+    // the number of bytes needed for every property in this group
+    atomic_size_t size;
+
+    _Atomic(ext_retainedAssociationOffsets *) retainedOffsets;
+};
+
+/*
+ * The storage for one group of associated properties of one object. Each
+ * property is assigned a fixed offset into the bytes when it is synthesized,
+ * so all objects share the same layout for each group.
+ */
+typedef struct ext_associationSlots {
+    // the storage for another group of the same object
+    struct ext_associationSlots *next;
+
+    ext_associationGroup *group;
+    size_t size;
+    unsigned char bytes[] __attribute__((aligned(EXT_ASSOCIATION_MAXIMUM_ALIGNMENT)));
+} ext_associationSlots;
+
+typedef struct {
+    // the address of the object which owns the slots, or zero if this entry
+    // is empty
+    uintptr_t object;
+
+    // the storage for every group which the object has set properties from
+    ext_associationSlots *slots;
+} ext_associationEntry;
+
+/*
+ * A hash table from objects to their slots, using open addressing with linear
+ * probing (like the tables in EXTADTTable.h).
+ */
+typedef struct {
+    os_unfair_lock lock;
+    ext_associationEntry *entries;
+
+    // always a power of two, or zero before anything has been inserted
+    size_t capacity;
+    size_t count;
+} __attribute__((aligned(64))) ext_associationStripe;
+
+/**
+ * Associated with each object that has slots, to free them when the object is
+ * deallocated.
+ */
+@interface EXTAssociationSlotsOwner : NSObject {
+@public
+    uintptr_t _object;
+}
+
+@end
+
+// the key for an object's EXTAssociationSlotsOwner
+static void *ext_associationSlotsOwnerKey = &ext_associationSlotsOwnerKey;
+
+static ext_associationStripe ext_associationStripes[EXT_ASSOCIATION_STRIPE_COUNT];
+
+// guards the synthesis of properties
+static os_unfair_lock ext_associationRegistryLock = OS_UNFAIR_LOCK_INIT;
+
+// every group of properties synthesized so far
+static ext_associationGroup *ext_associationGroups = NULL;
+
+/**
+ * Returns the table which holds the slots of the object at \a address.
+ */
+static ext_associationStripe *ext_associationStripeForAddress (uintptr_t address) {
+    return ext_associationStripes + (((address >> 4) ^ (address >> 9)) % EXT_ASSOCIATION_STRIPE_COUNT);
+}
+
+static size_t ext_associationHashForAddress (uintptr_t address) {
+    // objects are at least 16-byte aligned, and their low bits otherwise chose
+    // the stripe, so mix the higher bits down
+    return (size_t)((address >> 4) * 0x9E3779B97F4A7C15ULL >> 16);
+}
+
+/**
+ * Returns the entry for the object at \a address in \a stripe, or \c NULL if
+ * there is none.
+ *
+ * This must be called with the lock of \a stripe held.
+ */
+static ext_associationEntry *ext_findAssociationEntry (ext_associationStripe *stripe, uintptr_t address) {
+    if (!stripe->capacity)
+        return NULL;
+
+    size_t mask = stripe->capacity - 1;
+
+    for (size_t i = ext_associationHashForAddress(address) & mask;;i = (i + 1) & mask) {
+        ext_associationEntry *entry = stripe->entries + i;
+        if (entry->object == address)
+            return entry;
+
+        if (!entry->object)
+            return NULL;
+    }
+}
+
+/**
+ * Adds an entry (with no slots) for the object at \a address to \a stripe,
+ * which must not already contain one. Returns \c NULL if memory could not be
+ * allocated.
+ *
+ * This must be called with the lock of \a stripe held.
+ */
+static ext_associationEntry *ext_insertAssociationEntry (ext_associationStripe *stripe, uintptr_t address) {
+    // keep the load factor at or below 3/4
+    if ((stripe->count + 1) * 4 > stripe->capacity * 3) {
+        size_t capacity = (stripe->capacity ? stripe->capacity * 2 : 8);
+        size_t mask = capacity - 1;
+
+        ext_associationEntry *entries = calloc(capacity, sizeof(*entries));
+        if (!entries)
+            return NULL;
+
+        for (size_t i = 0;i < stripe->capacity;++i) {
+            ext_associationEntry *entry = stripe->entries + i;
+            if (!entry->object)
+                continue;
+
+            size_t j = ext_associationHashForAddress(entry->object) & mask;
+            while (entries[j].object)
+                j = (j + 1) & mask;
+
+            entries[j] = *entry;
+        }
+
+        free(stripe->entries);
+        stripe->entries = entries;
+        stripe->capacity = capacity;
+    }
+
+    size_t mask = stripe->capacity - 1;
+
+    size_t i = ext_associationHashForAddress(address) & mask;
+    while (stripe->entries[i].object)
+        i = (i + 1) & mask;
+
+    ext_associationEntry *entry = stripe->entries + i;
+    entry->object = address;
+    entry->slots = NULL;
+
+    ++stripe->count;
+    return entry;
+}
+
+/**
+ * Removes the entry for the object at \a address from \a stripe, and returns
+ * the list of its slots, or \c NULL if there was no such entry.
+ *
+ * This must be called with the lock of \a stripe held.
+ */
+static ext_associationSlots *ext_removeAssociationEntry (ext_associationStripe *stripe, uintptr_t address) {
+    ext_associationEntry *entry = ext_findAssociationEntry(stripe, address);
+    if (!entry)
+        return NULL;
+
+    ext_associationSlots *slots = entry->slots;
+
+    size_t mask = stripe->capacity - 1;
+    size_t hole = (size_t)(entry - stripe->entries);
+
+    // shift later entries in the same probe sequence backward to fill the
+    // hole, rather than leaving a tombstone
+    for (size_t i = (hole + 1) & mask;stripe->entries[i].object;i = (i + 1) & mask) {
+        size_t preferred = ext_associationHashForAddress(stripe->entries[i].object) & mask;
+        if (((i - preferred) & mask) >= ((i - hole) & mask)) {
+            stripe->entries[hole] = stripe->entries[i];
+            hole = i;
+        }
+    }
+
+    memset(stripe->entries + hole, 0, sizeof(*entry));
+    --stripe->count;
+    return slots;
+}
+
+/**
+ * Returns the slots of the object at \a address for \a group, with room for at
+ * least \a size bytes. If the object has no slots for the group (or too few),
+ * and \a create is \c YES, they're allocated or grown, and \a created is set
+ * to whether the object had no slots at all before. Otherwise, returns \c
+ * NULL.
+ *
+ * This must be called with the lock of \a stripe held, and the returned
+ * pointer is only valid until it is unlocked.
+ */
+static unsigned char *ext_associationSlotBytes (ext_associationStripe *stripe, uintptr_t address, ext_associationGroup *group, size_t size, BOOL create, BOOL *created) {
+    ext_associationEntry *entry = ext_findAssociationEntry(stripe, address);
+
+    // objects usually have slots for only one or two groups
+    ext_associationSlots **link = (entry ? &entry->slots : NULL);
+    while (link && *link && (*link)->group != group)
+        link = &(*link)->next;
+
+    ext_associationSlots *slots = (link ? *link : NULL);
+    if (slots && slots->size >= size)
+        return slots->bytes;
+
+    if (!create)
+        return NULL;
+
+    // make room for every property in the group, so that this object never
+    // needs to grow its slots unless more are loaded
+    size_t totalSize = atomic_load_explicit(&group->size, memory_order_relaxed);
+    if (totalSize < size)
+        totalSize = size;
+
+    BOOL existed = (slots != NULL);
+    size_t oldSize = (existed ? slots->size : 0);
+
+    slots = realloc(slots, sizeof(*slots) + totalSize);
+    if (!slots)
+        return NULL;
+
+    memset(slots->bytes + oldSize, 0, totalSize - oldSize);
+    slots->size = totalSize;
+
+    if (existed) {
+        *link = slots;
+        return slots->bytes;
+    }
+
+    if (!entry) {
+        entry = ext_insertAssociationEntry(stripe, address);
+        if (!entry) {
+            free(slots);
+            return NULL;
+        }
+
+        *created = YES;
+    }
+
+    slots->group = group;
+    slots->next = entry->slots;
+    entry->slots = slots;
+
+    return slots->bytes;
+}
+
+/**
+ * Releases the retained objects in \a slots, and every slots list after it,
+ * and frees them.
+ */
+static void ext_destroyAssociationSlots (ext_associationSlots *slots) {
+    while (slots) {
+        ext_retainedAssociationOffsets *retainedOffsets = atomic_load_explicit(&slots->group->retainedOffsets, memory_order_acquire);
+
+        for (size_t i = 0;retainedOffsets && i < retainedOffsets->count;++i) {
+            size_t offset = retainedOffsets->offsets[i];
+            if (offset + sizeof(void *) > slots->size)
+                continue;
+
+            void *value = *(void **)(slots->bytes + offset);
+            if (value)
+                CFRelease(value);
+        }
+
+        ext_associationSlots *next = slots->next;
+        free(slots);
+
+        slots = next;
+    }
+}
+
+@implementation EXTAssociationSlotsOwner
+
+- (void)dealloc {
+    ext_associationStripe *stripe = ext_associationStripeForAddress(_object);
+
+    os_unfair_lock_lock(&stripe->lock);
+    ext_associationSlots *slots = ext_removeAssociationEntry(stripe, _object);
+    os_unfair_lock_unlock(&stripe->lock);
+
+    // released values may own other objects with slots, so this must happen
+    // without the lock held
+    if (slots)
+        ext_destroyAssociationSlots(slots);
+}
+
+@end
+
+/**
+ * Arranges for the slots just created for \a object (at \a address) to be
+ * destroyed along with it.
+ */
+static void ext_attachAssociationSlotsOwner (id object, uintptr_t address) {
+    EXTAssociationSlotsOwner *owner = [[EXTAssociationSlotsOwner alloc] init];
+    owner->_object = address;
+
+    objc_setAssociatedObject(object, ext_associationSlotsOwnerKey, owner, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+}
+
+ext_associationGroup *ext_associationGroupForClass (Class cls, const char *file) {
+    NSCParameterAssert(cls != nil);
+    NSCParameterAssert(file != NULL);
+
+    os_unfair_lock_lock(&ext_associationRegistryLock);
+
+    ext_associationGroup *group = ext_associationGroups;
+    while (group && (group->cls != cls || strcmp(group->file, file) != 0))
+        group = group->next;
+
+    if (!group) {
+        group = calloc(1, sizeof(*group));
+        char *groupFile = strdup(file);
+
+        if (group && groupFile) {
+            group->cls = cls;
+            group->file = groupFile;
+
+            group->next = ext_associationGroups;
+            ext_associationGroups = group;
+        } else {
+            free(group);
+            free(groupFile);
+            group = NULL;
+        }
+    }
+
+    os_unfair_lock_unlock(&ext_associationRegistryLock);
+    return group;
+}
+
+size_t ext_addAssociationSlot (ext_associationGroup *group, size_t size, size_t alignment, BOOL retained) {
+    NSCParameterAssert(group != NULL);
+    NSCParameterAssert(size > 0);
+    NSCParameterAssert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    NSCParameterAssert(alignment <= EXT_ASSOCIATION_MAXIMUM_ALIGNMENT);
+
+    os_unfair_lock_lock(&ext_associationRegistryLock);
+
+    size_t groupSize = atomic_load_explicit(&group->size, memory_order_relaxed);
+    size_t offset = (groupSize + alignment - 1) & ~(alignment - 1);
+    atomic_store_explicit(&group->size, offset + size, memory_order_relaxed);
+
+    if (retained) {
+        ext_retainedAssociationOffsets *oldOffsets = atomic_load_explicit(&group->retainedOffsets, memory_order_relaxed);
+        size_t count = (oldOffsets ? oldOffsets->count : 0);
+
+        ext_retainedAssociationOffsets *newOffsets = malloc(sizeof(*newOffsets) + (count + 1) * sizeof(size_t));
+        if (newOffsets) {
+            if (oldOffsets)
+                memcpy(newOffsets->offsets, oldOffsets->offsets, count * sizeof(size_t));
+
+            newOffsets->offsets[count] = offset;
+            newOffsets->count = count + 1;
+
+            atomic_store_explicit(&group->retainedOffsets, newOffsets, memory_order_release);
+        } else {
+            NSLog(@"*** Could not allocate memory to record a retained associated property");
+        }
+    }
+
+    os_unfair_lock_unlock(&ext_associationRegistryLock);
+    return offset;
+}
+
+id ext_getAssociationSlotObject (id object, ext_associationGroup *group, size_t offset) {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    ext_associationStripe *stripe = ext_associationStripeForAddress(address);
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    unsigned char *bytes = ext_associationSlotBytes(stripe, address, group, offset + sizeof(void *), NO, NULL);
+
+    // retained before unlocking, so that a setter on another thread can't
+    // deallocate the value first
+    id value = (bytes ? (__bridge id)*(void **)(bytes + offset) : nil);
+
+    os_unfair_lock_unlock(&stripe->lock);
+    return value;
+}
+
+void ext_setAssociationSlotObject (id object, ext_associationGroup *group, size_t offset, id value, BOOL retained) {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    ext_associationStripe *stripe = ext_associationStripeForAddress(address);
+
+    void *newValue = (retained ? (void *)CFBridgingRetain(value) : (__bridge void *)value);
+    BOOL created = NO;
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    // setting nil on an object without slots doesn't need to create them
+    unsigned char *bytes = ext_associationSlotBytes(stripe, address, group, offset + sizeof(void *), newValue != NULL, &created);
+
+    void *oldValue = NULL;
+    if (bytes) {
+        oldValue = *(void **)(bytes + offset);
+        *(void **)(bytes + offset) = newValue;
+    }
+
+    os_unfair_lock_unlock(&stripe->lock);
+
+    if (!bytes && newValue) {
+        if (retained)
+            CFRelease(newValue);
+
+        NSCAssert(NO, @"Could not allocate memory for associated properties of %@", object);
+        return;
+    }
+
+    if (created)
+        ext_attachAssociationSlotsOwner(object, address);
+
+    if (retained && oldValue)
+        CFRelease(oldValue);
+}
+
+void ext_getAssociationSlotBytes (id object, ext_associationGroup *group, size_t offset, void *value, size_t size) {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    ext_associationStripe *stripe = ext_associationStripeForAddress(address);
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    unsigned char *bytes = ext_associationSlotBytes(stripe, address, group, offset + size, NO, NULL);
+    if (bytes)
+        memcpy(value, bytes + offset, size);
+    else
+        memset(value, 0, size);
+
+    os_unfair_lock_unlock(&stripe->lock);
+}
+
+void ext_setAssociationSlotBytes (id object, ext_associationGroup *group, size_t offset, const void *value, size_t size) {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    ext_associationStripe *stripe = ext_associationStripeForAddress(address);
+
+    // storing zero in an object without slots doesn't need to create them,
+    // since that's what they would be initialized to
+    BOOL zero = YES;
+    for (size_t i = 0;i < size && zero;++i) {
+        zero = (((const unsigned char *)value)[i] == 0);
+    }
+
+    BOOL created = NO;
+
+    os_unfair_lock_lock(&stripe->lock);
+
+    unsigned char *bytes = ext_associationSlotBytes(stripe, address, group, offset + size, !zero, &created);
+    if (bytes)
+        memcpy(bytes + offset, value, size);
+
+    os_unfair_lock_unlock(&stripe->lock);
+
+    if (!bytes && !zero) {
+        NSCAssert(NO, @"Could not allocate memory for associated properties of %@", object);
+        return;
+    }
+
+    if (created)
+        ext_attachAssociationSlotsOwner(object, address);
+}
+
+char *ext_copyAssociationMethodTypes (const char *first, const char *second, const char *third) {
+    size_t firstLength = strlen(first);
+    size_t secondLength = strlen(second);
+    size_t thirdLength = strlen(third);
+
+    char *types = malloc(firstLength + secondLength + thirdLength + 1);
+    if (!types)
+        return NULL;
+
+    memcpy(types, first, firstLength);
+    memcpy(types + firstLength, second, secondLength);
+    memcpy(types + firstLength + secondLength, third, thirdLength + 1);
+    return types;
+}
@@ -0,0 +1,128 @@
+//
+//  EXTUnowned.h
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import <Foundation/Foundation.h>
+#import "EXTScope.h"
+#import "metamacros.h"
+
+/**
+ * Whether stale accesses through #strongifyUnowned should crash the program,
+ * instead of evaluating to \c nil. This defaults to enabled in \c DEBUG builds,
+ * and can be overridden by defining it before including this header.
+ */
+#ifndef EXT_UNOWNED_TRAPS
+    #if defined(DEBUG) && !defined(NDEBUG)
+        #define EXT_UNOWNED_TRAPS 1
+    #else
+        #define EXT_UNOWNED_TRAPS 0
+    #endif
+#endif
+
+/**
+ * Creates unowned references for each of the variables provided as arguments,
+ * which can later be made strong again with #strongifyUnowned.
+ *
+ * This is an alternative to #weakify for code which captures and accesses the
+ * same objects from many threads at once. Weak references are tracked in a
+ * table shared by the whole process, and every load or store of a \c __weak
+ * variable takes a lock on it. Unowned references are instead checked against
+ * a small token attached to each object, which is invalidated when the object
+ * is deallocated. Capturing a variable finds its token in a cache indexed by
+ * the object's address, without locking. Accessing it again announces the
+ * accessing thread in memory of its own, rather than on the shared token, so
+ * threads accessing the same object only contend on its retain count, and
+ * then attempts to retain the object, which fails safely if the object has
+ * begun deallocating.
+ *
+ * Like unowned references in Swift, these are meant for objects which are
+ * expected to outlive the code referencing them. Accessing an unowned
+ * reference after its object has been deallocated evaluates to \c nil, or
+ * crashes if #EXT_UNOWNED_TRAPS is enabled.
+ *
+ * @code
+
+    @unownedify(self);
+
+    [self.connection setMessageHandler:^(NSData *message){
+        @strongifyUnowned(self);
+        [self handleMessage:message];
+    }];
+
+ * @endcode
+ *
+ * Accessing an unowned reference while its object is being deallocated, on
+ * another thread or from within the object's \c -dealloc, is treated the same
+ * as accessing it afterward.
+ */
+#define unownedify(...) \
+    ext_keywordify \
+    metamacro_foreach(ext_unownedify_,, __VA_ARGS__)
+
+/**
+ * Strongly references each of the variables provided as arguments, which must
+ * have previously been passed to #unownedify. Like #strongify, the strong
+ * references shadow the original variable names.
+ */
+#define strongifyUnowned(...) \
+    ext_keywordify \
+    _Pragma("clang diagnostic push") \
+    _Pragma("clang diagnostic ignored \"-Wshadow\"") \
+    metamacro_foreach(ext_strongifyUnowned_,, __VA_ARGS__) \
+    _Pragma("clang diagnostic pop")
+
+/**
+ * The liveness token shared by every unowned reference to an object.
+ */
+typedef struct ext_unownedToken ext_unownedToken;
+
+/**
+ * An unowned reference to an object, as created by #unownedify.
+ */
+typedef struct {
+    /**
+     * The referenced object, which is not retained.
+     */
+    __unsafe_unretained id object;
+
+    /**
+     * The liveness token for #object, or \c NULL if #object is \c nil.
+     */
+    ext_unownedToken *token;
+
+    /**
+     * The generation of #token when this reference was created.
+     */
+    unsigned long generation;
+} ext_unownedReference;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Returns an unowned reference to \a object, attaching a liveness token to it
+ * if it doesn't have one yet.
+ */
+ext_unownedReference ext_makeUnownedReference (id object);
+
+/**
+ * Returns the object of \a reference, retained, if it is still alive. If it has
+ * been deallocated, returns \c nil, or crashes if \a trap is \c YES.
+ */
+id ext_copyUnownedReferenceObject (const ext_unownedReference *reference, BOOL trap) NS_RETURNS_RETAINED;
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*** implementation details follow ***/
+#define ext_unownedify_(INDEX, VAR) \
+    const ext_unownedReference metamacro_concat(VAR, _unowned_) = ext_makeUnownedReference(VAR);
+
+#define ext_strongifyUnowned_(INDEX, VAR) \
+    __strong __typeof__(VAR) VAR = ext_copyUnownedReferenceObject(&metamacro_concat(VAR, _unowned_), EXT_UNOWNED_TRAPS);
@@ -0,0 +1,308 @@
+//
+//  EXTUnowned.m
+//  extobjc
+//
+//  Created on 2026-10-19.
+//  Released under the MIT license.
+//
+
+#import "EXTUnowned.h"
+#import <objc/message.h>
+#import <objc/runtime.h>
+#import <os/lock.h>
+#import <pthread.h>
+#import <sched.h>
+#import <stdatomic.h>
+#import <stdlib.h>
+
+// the number of independently locked lists of tokens, so that objects
+// referenced for the first time on different threads rarely contend
+#define EXT_UNOWNED_STRIPE_COUNT 64
+
+// the number of entries in the cache of tokens, which must be a power of two
+#define EXT_UNOWNED_CACHE_SIZE 4096
+
+/*
+ * The liveness token of a referenced object. Tokens are never freed, so that
+ * they can be read without any locking, even by stale references. Once their
+ * object has been deallocated, they're reused for other objects.
+ */
+struct ext_unownedToken {
+    // the address of the referenced object, or zero if the token is unused
+    _Atomic(uintptr_t) object;
+
+    // incremented when the referenced object is deallocated, so that
+    // references created before then can tell that it's gone, even after the
+    // token has been reused
+    _Atomic(unsigned long) generation;
+
+    // the number of threads currently trying to retain the referenced object
+    // through this token, which couldn't use their ext_unownedReader
+    _Atomic(unsigned long) readers;
+
+    // the next unused token, while this one is unused
+    struct ext_unownedToken *next;
+};
+
+/*
+ * Announces which token a thread is currently trying to retain an object
+ * through, so that threads reading through the same token don't all write to
+ * it. Each thread has its own reader, on its own cache line. Readers are never
+ * freed, and are reused once their thread exits.
+ */
+typedef struct ext_unownedReader {
+    _Atomic(ext_unownedToken *) token;
+
+    // whether a thread is using this reader
+    atomic_bool inUse;
+
+    struct ext_unownedReader *next;
+} __attribute__((aligned(64))) ext_unownedReader;
+
+typedef struct {
+    os_unfair_lock lock;
+
+    // tokens which can be reused
+    ext_unownedToken *unusedTokens;
+} __attribute__((aligned(64))) ext_unownedStripe;
+
+/**
+ * Associated with each referenced object, so that its token is invalidated
+ * when the object is deallocated.
+ */
+@interface EXTUnownedSentinel : NSObject {
+@public
+    ext_unownedToken *_token;
+}
+
+@end
+
+// the key for an object's EXTUnownedSentinel
+static void *ext_unownedSentinelKey = &ext_unownedSentinelKey;
+
+static ext_unownedStripe ext_unownedStripes[EXT_UNOWNED_STRIPE_COUNT];
+
+// the token most recently used for an object, indexed by a hash of its
+// address, so that capturing an object again doesn't need to look up its
+// sentinel
+static _Atomic(ext_unownedToken *) ext_unownedTokenCache[EXT_UNOWNED_CACHE_SIZE];
+
+// every reader ever created, which is checked when an object is deallocated
+static _Atomic(ext_unownedReader *) ext_unownedReaders = NULL;
+
+// the reader of the current thread, once it has one
+static __thread ext_unownedReader *ext_currentUnownedReader = NULL;
+
+// releases the reader of a thread when it exits
+static pthread_key_t ext_unownedReaderKey;
+
+static SEL ext_retainWeakReferenceSelector (void) {
+    static SEL selector = NULL;
+    static dispatch_once_t onceToken;
+
+    // ARC doesn't allow this selector to be written with @selector()
+    dispatch_once(&onceToken, ^{
+        selector = sel_registerName("retainWeakReference");
+    });
+
+    return selector;
+}
+
+static void ext_releaseUnownedReader (void *value) {
+    ext_unownedReader *reader = value;
+
+    ext_currentUnownedReader = NULL;
+    atomic_store_explicit(&reader->inUse, false, memory_order_release);
+}
+
+/**
+ * Returns the reader of the current thread, claiming an unused one or
+ * allocating a new one if necessary. Returns \c NULL if memory could not be
+ * allocated.
+ */
+static ext_unownedReader *ext_unownedReaderForCurrentThread (void) {
+    ext_unownedReader *reader = ext_currentUnownedReader;
+    if (reader)
+        return reader;
+
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&ext_unownedReaderKey, &ext_releaseUnownedReader);
+    });
+
+    // reuse the reader of a thread which has exited, if there is one
+    for (reader = atomic_load_explicit(&ext_unownedReaders, memory_order_acquire);reader;reader = reader->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&reader->inUse, &expected, true, memory_order_acquire, memory_order_relaxed))
+            break;
+    }
+
+    if (!reader) {
+        if (posix_memalign((void **)&reader, __alignof__(ext_unownedReader), sizeof(*reader)) != 0)
+            return NULL;
+
+        atomic_init(&reader->token, NULL);
+        atomic_init(&reader->inUse, true);
+
+        reader->next = atomic_load_explicit(&ext_unownedReaders, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&ext_unownedReaders, &reader->next, reader, memory_order_seq_cst, memory_order_relaxed)) {
+            // reader->next was updated with the current head
+        }
+    }
+
+    pthread_setspecific(ext_unownedReaderKey, reader);
+    ext_currentUnownedReader = reader;
+    return reader;
+}
+
+static ext_unownedStripe *ext_unownedStripeForAddress (uintptr_t address) {
+    return ext_unownedStripes + (((address >> 4) ^ (address >> 9)) % EXT_UNOWNED_STRIPE_COUNT);
+}
+
+static _Atomic(ext_unownedToken *) *ext_unownedTokenCacheEntryForAddress (uintptr_t address) {
+    return ext_unownedTokenCache + (((address >> 4) ^ (address >> 16)) & (EXT_UNOWNED_CACHE_SIZE - 1));
+}
+
+@implementation EXTUnownedSentinel
+
+- (void)dealloc {
+    ext_unownedToken *token = _token;
+    uintptr_t address = atomic_load_explicit(&token->object, memory_order_relaxed);
+
+    // the referenced object is already deallocating, so any thread which
+    // sees the old generation will fail to retain it; wait for those threads
+    // before the object's memory is freed
+    atomic_fetch_add_explicit(&token->generation, 1, memory_order_seq_cst);
+
+    // readers added after this are guaranteed to see the new generation
+    for (ext_unownedReader *reader = atomic_load_explicit(&ext_unownedReaders, memory_order_seq_cst);reader;reader = reader->next) {
+        while (atomic_load_explicit(&reader->token, memory_order_seq_cst) == token)
+            sched_yield();
+    }
+
+    while (atomic_load_explicit(&token->readers, memory_order_seq_cst) != 0)
+        sched_yield();
+
+    atomic_store_explicit(&token->object, 0, memory_order_release);
+
+    ext_unownedStripe *stripe = ext_unownedStripeForAddress(address);
+    os_unfair_lock_lock(&stripe->lock);
+
+    token->next = stripe->unusedTokens;
+    stripe->unusedTokens = token;
+
+    os_unfair_lock_unlock(&stripe->lock);
+}
+
+@end
+
+/**
+ * Returns the token of \a object, attaching a sentinel with a new token to it
+ * if it doesn't have one yet. Returns \c NULL if memory could not be allocated.
+ */
+static ext_unownedToken *ext_unownedTokenForObject (id object, uintptr_t address) {
+    ext_unownedStripe *stripe = ext_unownedStripeForAddress(address);
+
+    // the stripe's lock ensures that only one sentinel is ever attached to the
+    // object
+    os_unfair_lock_lock(&stripe->lock);
+
+    EXTUnownedSentinel *sentinel = objc_getAssociatedObject(object, ext_unownedSentinelKey);
+    if (!sentinel) {
+        ext_unownedToken *token = stripe->unusedTokens;
+        if (token)
+            stripe->unusedTokens = token->next;
+        else
+            token = calloc(1, sizeof(*token));
+
+        if (!token) {
+            os_unfair_lock_unlock(&stripe->lock);
+            return NULL;
+        }
+
+        token->next = NULL;
+        atomic_store_explicit(&token->object, address, memory_order_release);
+
+        sentinel = [[EXTUnownedSentinel alloc] init];
+        sentinel->_token = token;
+
+        objc_setAssociatedObject(object, ext_unownedSentinelKey, sentinel, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    os_unfair_lock_unlock(&stripe->lock);
+    return sentinel->_token;
+}
+
+ext_unownedReference ext_makeUnownedReference (id object) {
+    if (!object)
+        return (ext_unownedReference){ .object = nil, .token = NULL, .generation = 0 };
+
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    _Atomic(ext_unownedToken *) *cacheEntry = ext_unownedTokenCacheEntryForAddress(address);
+
+    // since the caller holds a strong reference to the object, a token whose
+    // address matches must belong to it, and can't be invalidated until it's
+    // released
+    ext_unownedToken *token = atomic_load_explicit(cacheEntry, memory_order_acquire);
+    if (!token || atomic_load_explicit(&token->object, memory_order_acquire) != address) {
+        token = ext_unownedTokenForObject(object, address);
+        NSCAssert(token, @"Could not allocate memory for an unowned reference to %@", object);
+
+        atomic_store_explicit(cacheEntry, token, memory_order_release);
+    }
+
+    return (ext_unownedReference){
+        .object = object,
+        .token = token,
+        .generation = (token ? atomic_load_explicit(&token->generation, memory_order_relaxed) : 0)
+    };
+}
+
+/**
+ * Retains the object of \a reference, if \a token still has the same
+ * generation. The current thread must have been announced as a reader of \a
+ * token.
+ */
+static BOOL ext_retainUnownedObject (const ext_unownedReference *reference, ext_unownedToken *token) {
+    if (atomic_load_explicit(&token->generation, memory_order_seq_cst) != reference->generation)
+        return NO;
+
+    return ((BOOL (*)(id, SEL))objc_msgSend)(reference->object, ext_retainWeakReferenceSelector());
+}
+
+id ext_copyUnownedReferenceObject (const ext_unownedReference *reference, BOOL trap) {
+    ext_unownedToken *token = reference->token;
+    if (!token)
+        return nil;
+
+    // if the generation still matches after announcing this thread, the
+    // object's memory can't be freed until this thread is done, and
+    // -retainWeakReference atomically fails if the object has already begun
+    // deallocating
+    BOOL retained;
+
+    ext_unownedReader *reader = ext_unownedReaderForCurrentThread();
+    if (reader && !atomic_load_explicit(&reader->token, memory_order_relaxed)) {
+        atomic_store_explicit(&reader->token, token, memory_order_seq_cst);
+        retained = ext_retainUnownedObject(reference, token);
+        atomic_store_explicit(&reader->token, NULL, memory_order_release);
+    } else {
+        // the reader couldn't be allocated, or is already in use further up
+        // the stack (such as if -retainWeakReference reads another unowned
+        // reference), so announce this thread on the token itself
+        atomic_fetch_add_explicit(&token->readers, 1, memory_order_seq_cst);
+        retained = ext_retainUnownedObject(reference, token);
+        atomic_fetch_sub_explicit(&token->readers, 1, memory_order_release);
+    }
+
+    if (!retained) {
+        if (trap) {
+            NSLog(@"*** Attempted to access an unowned reference to %p after it was deallocated", (__bridge void *)reference->object);
+            __builtin_trap();
+        }
+
+        return nil;
+    }
+
+    return (__bridge_transfer id)(__bridge void *)reference->object;
+}
@@ -8,13 +8,21 @@
 //
 
 #import "EXTADT.h"
+#import "EXTADTTable.h"
+#import "EXTAsyncCoroutine.h"
+#import "EXTChannel.h"
 #import "EXTConcreteProtocol.h"
+#import "EXTCoroutineEnumerator.h"
+#import "EXTKeyPath.h"
 #import "EXTKeyPathCoding.h"
 #import "EXTNil.h"
+#import "EXTObservation.h"
 #import "EXTSafeCategory.h"
 #import "EXTScope.h"
 #import "EXTSelectorChecking.h"
+#import "EXTStreamReader.h"
 #import "EXTSynthesize.h"
+#import "EXTUnowned.h"
 #import "NSInvocation+EXT.h"
 #import "NSMethodSignature+EXT.h"
 